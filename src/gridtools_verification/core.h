@@ -14,6 +14,8 @@
 #include "core/command_line.h"
 #include "core/error.h"
 #include "core/logger.h"
+#include "core/loop_nest.h"
+#include "core/parallel.h"
 #include "core/serialization.h"
 #include "core/type_erased_field.h"
 #include "core/utility.h"
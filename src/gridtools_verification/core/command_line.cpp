@@ -16,6 +16,8 @@
 #include <string>
 #include <vector>
 #include "logger.h"
+#include "reference_cache.h"
+#include <algorithm>
 
 namespace po = boost::program_options;
 
@@ -35,6 +37,36 @@ namespace gt_verification {
                 "over the environment variable.")
             // --log, -l
             ("log,l", "Enable verbose logging to std::clog.")
+            // --log-file
+            ("log-file",
+                po::value< std::string >()->value_name("PATH"),
+                "Write the log to the file PATH instead of std::clog (implies --log). This argument takes "
+                "precedence over the environment variable.")
+            // --threads, -t
+            ("threads,t",
+                po::value< int >()->value_name("N"),
+                "Number of threads used to load the fields and to verify the output fields. If N is 0, all hardware "
+                "threads are used. This argument takes precedence over the environment variable.")
+            // --cache
+            ("cache",
+                po::value< int >()->value_name("MB"),
+                "Keep up to MB megabytes of loaded reference data in memory to avoid reading the same fields "
+                "again. This argument takes precedence over the environment variable.")
+            // --prefetch
+            ("prefetch",
+                "Load the next iteration of the reference data in the background while verifying (ignored with "
+                "--stream).")
+            // --stream
+            ("stream",
+                po::value< int >()->value_name("K"),
+                "Verify the reference fields of Binary archives in slabs of K layers directly from the archive "
+                "and release each slab after it has been verified. The checksums of the mapped fields are not "
+                "validated.")
+            // --timing
+            ("timing",
+                po::value< std::string >()->implicit_value("")->value_name("PATH"),
+                "Measure the time spent per test in loading, running the stencil, verifying and reporting and print "
+                "a table at the end (or write it as CSV to PATH).")
             // --error
             ("error",
                 po::value< std::string >()->value_name("KEYWORDS"),
@@ -58,12 +90,27 @@ namespace gt_verification {
                 po::variable_value variableValue(boost::any(std::string(envDycoreLocation)), false);
                 variableMap_.insert(std::make_pair("path", variableValue));
             }
+
+            const char *envThreads = std::getenv("VERIFICATION_THREADS");
+
+            if (!has("threads") && envThreads) {
+                po::variable_value variableValue(boost::any(std::atoi(envThreads)), false);
+                variableMap_.insert(std::make_pair("threads", variableValue));
+            }
         } catch (const std::exception &e) {
             error::fatal(boost::format("%s, for help type '%s --help'") % e.what() % argv[0]);
         }
 
-        if (has("log"))
+        if (has("log-file"))
+            logger::getInstance().set_sink(as< std::string >("log-file"));
+
+        if (has("log") || has("log-file"))
             logger::getInstance().enable();
+
+        if (has("cache")) {
+            const std::size_t megabytes = std::max(0, as< int >("cache"));
+            reference_cache::get_instance().set_budget(megabytes << 20);
+        }
     }
 
     void command_line::print_help(char *currentExecutable) const noexcept {
@@ -72,6 +119,12 @@ namespace gt_verification {
                   << boost::format("  %-22s %s.\n") % "DYCORE_DATA_LOCATION" %
                          "Alternative way of specifying the input path"
                   << boost::format("  %-22s %s.\n") % "VERIFICATION_LOG" % "Enable logging if value is positve"
+                  << boost::format("  %-22s %s.\n") % "VERIFICATION_LOG_FILE" %
+                         "Alternative way of specifying the log file"
+                  << boost::format("  %-22s %s.\n") % "VERIFICATION_THREADS" %
+                         "Alternative way of specifying the number of threads"
+                  << boost::format("  %-22s %s.\n") % "VERIFICATION_CACHE" %
+                         "Alternative way of specifying the size of the reference cache (in MB)"
                   << std::endl;
         std::exit(EXIT_SUCCESS);
     }
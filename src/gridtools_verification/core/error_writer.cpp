@@ -0,0 +1,96 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "error_writer.h"
+#include "error.h"
+#include "logger.h"
+
+namespace gt_verification {
+
+    error_writer::error_writer(serializer_factory factory, std::size_t maxBytes)
+        : factory_(factory), maxBytes_(maxBytes), bytes_(0), limitReached_(false), busy_(false), stop_(false) {}
+
+    error_writer::error_writer(std::shared_ptr< ser::serializer > serializer, std::size_t maxBytes)
+        : serializer_(serializer), maxBytes_(maxBytes), bytes_(0), limitReached_(false), busy_(false),
+          stop_(false) {}
+
+    error_writer::~error_writer() {
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            stop_ = true;
+        }
+        wakeup_.notify_one();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    std::shared_ptr< ser::serializer > error_writer::serializer() {
+        std::lock_guard< std::mutex > lock(serializerMutex_);
+        if (!serializer_ && factory_) {
+            VERIFICATION_LOG() << "Opening error serializer" << logger_action::endl;
+            serializer_ = factory_();
+        }
+        return serializer_;
+    }
+
+    void error_writer::flush() {
+        std::unique_lock< std::mutex > lock(mutex_);
+        idle_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+    }
+
+    bool error_writer::reserve(std::size_t bytes, const std::string &name) {
+        std::lock_guard< std::mutex > lock(mutex_);
+        if (bytes_ + bytes > maxBytes_) {
+            if (!limitReached_)
+                error::warning(boost::format("not writing the failures of '%s' (and all following ones) to the error "
+                                             "serializer: the limit of %g MB is reached") %
+                               name % (maxBytes_ / double(1 << 20)));
+            limitReached_ = true;
+            return false;
+        }
+        bytes_ += bytes;
+        return true;
+    }
+
+    void error_writer::enqueue(std::function< void() > task) {
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            tasks_.push_back(std::move(task));
+            if (!thread_.joinable())
+                thread_ = std::thread(&error_writer::run, this);
+        }
+        wakeup_.notify_one();
+    }
+
+    void error_writer::run() {
+        std::unique_lock< std::mutex > lock(mutex_);
+        while (true) {
+            wakeup_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty())
+                break;
+
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            busy_ = true;
+            lock.unlock();
+
+            try {
+                task();
+            } catch (std::exception &e) {
+                error::warning(boost::format("failed to write to the error serializer: %s") % e.what());
+            }
+
+            lock.lock();
+            busy_ = false;
+            if (tasks_.empty())
+                idle_.notify_all();
+        }
+    }
+} // namespace gt_verification
@@ -0,0 +1,144 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include "serialization.h"
+#include "type_erased_field.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace gt_verification {
+
+    /**
+     * @brief Write the fields of failed verifications to the error serializer on a background thread
+     *
+     * For a failed verification of the field `name`, the fields `name_out` (output), `name_ref` (reference) and
+     * `name_diff` (output - reference) are written at the savepoint of the reference data. The output and the
+     * reference field are copied when they are queued, i.e the caller can continue to modify them. The
+     * difference is computed on the writer thread.
+     *
+     * The serializer and the writer thread are only created when the first failure is written. Hence, a run
+     * without failures does not do any file I/O. Failures are dropped once the number of bytes written
+     * reaches the limit.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class error_writer : private boost::noncopyable {
+      public:
+        using serializer_factory = std::function< std::shared_ptr< ser::serializer >() >;
+
+        /**
+         * @brief Writer which creates its serializer with @c factory on first use
+         *
+         * @param factory   Function which opens the serializer in write mode
+         * @param maxBytes  Maximum number of bytes to write
+         */
+        error_writer(serializer_factory factory, std::size_t maxBytes);
+
+        /**
+         * @brief Writer to a serializer which is already open in write mode
+         */
+        error_writer(std::shared_ptr< ser::serializer > serializer, std::size_t maxBytes);
+
+        /**
+         * @brief Write the queued failures and stop the writer thread
+         */
+        ~error_writer();
+
+        /**
+         * @brief Queue the output field, the reference field and their difference for writing
+         *
+         * The limit of bytes is checked before the fields are copied.
+         *
+         * @return @c false if the failure is dropped because of the limit of bytes
+         */
+        template < typename T >
+        bool write_failure(const std::string &name,
+            const type_erased_field_view< T > &output,
+            const type_erased_field_view< T > &reference,
+            const ser::savepoint &savepoint) {
+            const std::array< int, 3 > sizes{{output.i_size(), output.j_size(), output.k_size()}};
+            const std::size_t size = sizes[0] * sizes[1] * sizes[2];
+            if (!reserve(3 * size * sizeof(T), name))
+                return false;
+
+            // Snapshot of the fields (contiguous with the first dimension running fastest), the difference is only
+            // computed on the writer thread
+            auto allocate = [name, sizes, size]() {
+                std::shared_ptr< T > data(new T[size], std::default_delete< T[] >());
+                return type_erased_field< T >(data, name, sizes, {{1, sizes[0], sizes[0] * sizes[1]}});
+            };
+            type_erased_field< T > out = allocate(), ref = allocate();
+            copy_field(output, out.to_view());
+            copy_field(reference, ref.to_view());
+
+            enqueue([this, name, out, ref, allocate, size, savepoint]() mutable {
+                type_erased_field< T > diff = allocate();
+                for (std::size_t idx = 0; idx < size; ++idx)
+                    diff.data()[idx] = out.data()[idx] - ref.data()[idx];
+
+                serialization serialization(serializer());
+                serialization.write(name + "_out", out.to_view(), savepoint);
+                serialization.write(name + "_ref", ref.to_view(), savepoint);
+                serialization.write(name + "_diff", diff.to_view(), savepoint);
+            });
+            return true;
+        }
+
+        /**
+         * @brief Wait until all queued failures are written
+         */
+        void flush();
+
+        /**
+         * @brief Get the serializer (it is opened if this has not happened yet)
+         */
+        std::shared_ptr< ser::serializer > serializer();
+
+        /**
+         * @brief Number of bytes of the queued failures
+         */
+        std::size_t bytes() const noexcept { return bytes_; }
+
+        /**
+         * @brief Maximum number of bytes to write
+         */
+        std::size_t max_bytes() const noexcept { return maxBytes_; }
+
+      private:
+        bool reserve(std::size_t bytes, const std::string &name);
+        void enqueue(std::function< void() > task);
+        void run();
+
+        serializer_factory factory_;
+        std::mutex serializerMutex_;
+        std::shared_ptr< ser::serializer > serializer_;
+
+        const std::size_t maxBytes_;
+        std::size_t bytes_;
+        bool limitReached_;
+
+        std::mutex mutex_;
+        std::condition_variable wakeup_;
+        std::condition_variable idle_;
+        std::deque< std::function< void() > > tasks_;
+        bool busy_;
+        bool stop_;
+        std::thread thread_;
+    };
+} // namespace gt_verification
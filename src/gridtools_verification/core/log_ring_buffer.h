@@ -0,0 +1,131 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace gt_verification {
+
+    /**
+     * @brief Lock-free single-producer single-consumer ring buffer of messages
+     *
+     * Each message is stored as its length (uint32) followed by its characters and may wrap around the end of
+     * the buffer. push() is called by a single producer thread and pop() by a single consumer thread; the two
+     * only synchronize via the atomic write and read positions.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class log_ring_buffer : private boost::noncopyable {
+      public:
+        /**
+         * @brief Allocate a buffer of @c capacity bytes (rounded up to a power of two)
+         */
+        explicit log_ring_buffer(std::size_t capacity) : capacity_(round_up(capacity)), mask_(capacity_ - 1),
+            data_(new char[capacity_]), head_(0), tail_(0), orphaned_(false) {}
+
+        /**
+         * @brief Append a message (producer)
+         *
+         * @return False if the message does not fit into the free space (it is not written)
+         */
+        bool push(const char *message, std::size_t size) noexcept {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            if (sizeof(std::uint32_t) + size > capacity_ - (head - tail))
+                return false;
+
+            const std::uint32_t length = std::uint32_t(size);
+            copy_in(head, reinterpret_cast< const char * >(&length), sizeof(length));
+            copy_in(head + sizeof(length), message, size);
+            head_.store(head + sizeof(length) + size, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Remove the oldest message and store it in @c message (consumer)
+         *
+         * @return False if the buffer is empty
+         */
+        bool pop(std::string &message) {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            if (tail == head)
+                return false;
+
+            std::uint32_t length;
+            copy_out(tail, reinterpret_cast< char * >(&length), sizeof(length));
+            message.resize(length);
+            copy_out(tail + sizeof(length), &message[0], length);
+            tail_.store(tail + sizeof(length) + length, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Check whether the buffer is empty (consumer)
+         */
+        bool empty() const noexcept {
+            return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Capacity in bytes (including the length of each message)
+         */
+        std::size_t capacity() const noexcept { return capacity_; }
+
+        /**
+         * @brief Mark the buffer as no longer used by its producer
+         */
+        void orphan() noexcept { orphaned_.store(true, std::memory_order_release); }
+
+        /**
+         * @brief Check whether the producer has released the buffer
+         */
+        bool orphaned() const noexcept { return orphaned_.load(std::memory_order_acquire); }
+
+      private:
+        static std::size_t round_up(std::size_t capacity) noexcept {
+            std::size_t size = 64;
+            while (size < capacity)
+                size <<= 1;
+            return size;
+        }
+
+        void copy_in(std::size_t position, const char *src, std::size_t size) noexcept {
+            const std::size_t offset = position & mask_;
+            const std::size_t first = std::min(size, capacity_ - offset);
+            std::memcpy(data_.get() + offset, src, first);
+            std::memcpy(data_.get(), src + first, size - first);
+        }
+
+        void copy_out(std::size_t position, char *dst, std::size_t size) const noexcept {
+            const std::size_t offset = position & mask_;
+            const std::size_t first = std::min(size, capacity_ - offset);
+            std::memcpy(dst, data_.get() + offset, first);
+            std::memcpy(dst + first, data_.get(), size - first);
+        }
+
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        std::unique_ptr< char[] > data_;
+
+        // The positions increase monotonically and are written by different threads
+        alignas(64) std::atomic< std::size_t > head_; ///< Written by the producer
+        alignas(64) std::atomic< std::size_t > tail_; ///< Written by the consumer
+        std::atomic< bool > orphaned_;
+    };
+} // namespace gt_verification
@@ -10,22 +10,207 @@
 
 #include "logger.h"
 #include "command_line.h"
+#include "../verification_exception.h"
+#include <algorithm>
 #include <cstdlib>
-#include <iostream>
+#include <unistd.h>
 
 namespace gt_verification {
 
-    logger *logger::instance_ = nullptr;
+    namespace {
+        /// Capacity of the ring buffer of each thread
+        constexpr std::size_t ring_buffer_capacity = std::size_t(1) << 16;
 
-    logger &logger::getInstance() {
+        /// Interval in which the background thread drains the ring buffers if it is not woken up
+        constexpr std::chrono::milliseconds writer_interval(50);
+    } // namespace
+
+    std::atomic< logger * > logger::instance_(nullptr);
+
+    logger &logger::create_instance() {
+        static std::mutex mutex;
+        std::lock_guard< std::mutex > lock(mutex);
         if (!instance_)
             instance_ = new logger;
-        return (*instance_);
+        return (*instance_.load());
     }
 
-    logger::logger() : enable_(false), flushed_(true), outStream_(std::clog) {
+    logger::logger()
+        : enable_(false), numDropped_(0), numThreads_(0), pending_(false), stop_(false), syncRequested_(0),
+          syncCompleted_(0), writerPid_(0), sink_(stderr), numDroppedReported_(0) {
+        // The logger is never destroyed, the remaining messages are written at exit
+        std::atexit([] { logger::getInstance().stop_writer(); });
+
         // Check environment variable
         const char *envDycoreLog = std::getenv("VERIFICATION_LOG"); // FIXME
-        enable_ = envDycoreLog && (std::atoi(envDycoreLog) > 0);
+        const char *envLogFile = std::getenv("VERIFICATION_LOG_FILE");
+        if (envLogFile && *envLogFile)
+            set_sink(envLogFile);
+        if (envDycoreLog && (std::atoi(envDycoreLog) > 0))
+            enable();
+    }
+
+    logger::thread_state::thread_state()
+        : flushed(true), buffer(std::make_shared< log_ring_buffer >(ring_buffer_capacity)), second(-1),
+          time{'[', '0', '0', ':', '0', '0', ':', '0', '0', '.', '0', '0', '0'} {
+        logger &log = logger::getInstance();
+        std::lock_guard< std::mutex > lock(log.buffersMutex_);
+        id = log.numThreads_++;
+        log.buffers_.push_back(buffer);
+        tag = " T" + std::to_string(id) + "] ";
+    }
+
+    logger::thread_state::~thread_state() {
+        if (!flushed)
+            logger::getInstance().commit(*this);
+        buffer->orphan();
+    }
+
+    logger::thread_state &logger::local_state() {
+        thread_local thread_state state;
+        return state;
+    }
+
+    void logger::enable() {
+        start_writer();
+        enable_ = true;
+    }
+
+    void logger::set_sink(const std::string &path) {
+        std::FILE *sink = stderr;
+        if (!path.empty() && !(sink = std::fopen(path.c_str(), "w")))
+            throw verification_exception("cannot open the log file '%s'", path);
+
+        sync();
+        std::lock_guard< std::mutex > lock(sinkMutex_);
+        if (sink_ != stderr)
+            std::fclose(sink_);
+        sink_ = sink;
+    }
+
+    void logger::sync() {
+        std::unique_lock< std::mutex > lock(writerMutex_);
+        if (!owns_writer())
+            return;
+        const std::size_t ticket = ++syncRequested_;
+        wakeWriter_.notify_one();
+        synced_.wait(lock, [&] { return syncCompleted_ >= ticket; });
+    }
+
+    void logger::write_prefix(thread_state &state) noexcept {
+        auto digits = [](char *str, int value, int count) {
+            for (int n = count - 1; n >= 0; --n, value /= 10)
+                str[n] = char('0' + value % 10);
+        };
+
+        const auto milliseconds = std::chrono::duration_cast< std::chrono::milliseconds >(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const std::time_t second = std::time_t(milliseconds / 1000);
+
+        // The local time is only converted (and formatted) once per second
+        if (second != state.second) {
+            struct tm localTime;
+            localtime_r(&second, &localTime);
+            digits(state.time + 1, localTime.tm_hour, 2);
+            digits(state.time + 4, localTime.tm_min, 2);
+            digits(state.time + 7, localTime.tm_sec, 2);
+            state.second = second;
+        }
+        digits(state.time + 10, int(milliseconds % 1000), 3);
+
+        state.line.write(state.time, sizeof(state.time));
+        state.line.write(state.tag.data(), state.tag.size());
+    }
+
+    void logger::commit(thread_state &state) noexcept {
+        const std::string message = state.line.str();
+        state.line.str(std::string());
+        state.flushed = true;
+        if (message.empty())
+            return;
+
+        if (!state.buffer->push(message.data(), message.size()))
+            ++numDropped_;
+
+        // Notifying without holding the mutex may miss a writer which is about to wait; it then wakes up after
+        // the writer interval
+        pending_.store(true, std::memory_order_release);
+        wakeWriter_.notify_one();
+    }
+
+    void logger::start_writer() {
+        std::lock_guard< std::mutex > lock(writerMutex_);
+        if (!writer_.joinable() && !stop_) {
+            writer_ = std::thread([this] { run_writer(); });
+            writerPid_ = getpid();
+        }
+    }
+
+    bool logger::owns_writer() const noexcept {
+        // A forked child inherits writer_, but not the thread itself
+        return writer_.joinable() && writerPid_ == getpid();
+    }
+
+    void logger::stop_writer() {
+        {
+            std::lock_guard< std::mutex > lock(writerMutex_);
+            if (!owns_writer())
+                return;
+            stop_ = true;
+        }
+        wakeWriter_.notify_one();
+        writer_.join();
+
+        // Messages committed by other threads in the meantime
+        drain();
+    }
+
+    void logger::run_writer() {
+        std::unique_lock< std::mutex > lock(writerMutex_);
+        while (true) {
+            wakeWriter_.wait_for(lock, writer_interval, [&] {
+                return stop_ || syncRequested_ != syncCompleted_ || pending_.load(std::memory_order_acquire);
+            });
+            const std::size_t ticket = syncRequested_;
+            const bool stop = stop_;
+            pending_.store(false, std::memory_order_relaxed);
+
+            lock.unlock();
+            drain();
+            lock.lock();
+
+            syncCompleted_ = ticket;
+            synced_.notify_all();
+            if (stop)
+                break;
+        }
+    }
+
+    void logger::drain() {
+        // Drop the buffers of exited threads once they are empty (an orphaned buffer receives no further messages)
+        std::vector< std::shared_ptr< log_ring_buffer > > buffers;
+        {
+            std::lock_guard< std::mutex > lock(buffersMutex_);
+            buffers = buffers_;
+            buffers_.erase(std::remove_if(buffers_.begin(),
+                               buffers_.end(),
+                               [](const std::shared_ptr< log_ring_buffer > &buffer) {
+                                   return buffer->orphaned() && buffer->empty();
+                               }),
+                buffers_.end());
+        }
+
+        std::lock_guard< std::mutex > lock(sinkMutex_);
+        std::string message;
+        for (auto &buffer : buffers)
+            while (buffer->pop(message))
+                std::fwrite(message.data(), 1, message.size(), sink_);
+
+        const std::size_t numDropped = numDropped_;
+        if (numDropped != numDroppedReported_) {
+            std::fprintf(sink_, "[logger] %zu message(s) dropped\n", numDropped - numDroppedReported_);
+            numDroppedReported_ = numDropped;
+        }
+        std::fflush(sink_);
     }
 } // namespace gt_verification
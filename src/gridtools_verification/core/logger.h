@@ -11,11 +11,34 @@
 #pragma once
 
 #include "include_boost_format.h"
+#include "log_ring_buffer.h"
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <sstream>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
 #include "../common.h"
 
+/**
+ * @def GT_VERIFICATION_LOG_LEVEL
+ * @brief Compile-time log level (0: no logging, 1: info, 2: debug)
+ *
+ * Logs above this level are removed at compile time (see VERIFICATION_LOG_INFO() and VERIFICATION_LOG_DEBUG()).
+ *
+ * @ingroup Logger
+ */
+#ifndef GT_VERIFICATION_LOG_LEVEL
+#define GT_VERIFICATION_LOG_LEVEL 2
+#endif
+
 namespace gt_verification {
 
     /**
@@ -25,19 +48,26 @@ namespace gt_verification {
      * The logger can log every object which provides a stream operator<< for std::clog. The Logger
      * object will be created upon first invocation.
      *
-     * Every invocation of the macro VERIFICATION_LOG() will print the current date-time and insert a
-     * newline
-     * character/flush the stream (if it has not been manually done by dycore::log::flush or
-     * dycore::log::endl).
+     * Every invocation of the macro VERIFICATION_LOG() will print the current date-time and the id of the
+     * calling thread and insert a newline character (if it has not been manually done by logger_action::endl).
+     *
+     * The logger is asynchronous: each thread formats its messages into its own lock-free ring buffer which is
+     * drained by a background thread writing to the sink (standard error by default). Logging thus never waits for
+     * I/O; if a ring buffer is full, the message is dropped and the number of dropped messages is logged.
+     *
+     * The arguments of VERIFICATION_LOG_INFO() are only evaluated if the logger is enabled. Detailed logs (e.g. of
+     * every loaded field) use VERIFICATION_LOG_DEBUG() and can be removed at compile time by setting
+     * GT_VERIFICATION_LOG_LEVEL to 1.
      *
      * The logger can be enabled by passing the command_line option --log (-l) or by setting the
-     * environment variable VERIFICATION_LOG to a @b positive value.
+     * environment variable VERIFICATION_LOG to a @b positive value. The option --log-file (or the environment
+     * variable VERIFICATION_LOG_FILE) redirects the log to a file.
      *
      * To use the logger:
      * @code{.cpp}
      *  VERIFICATION_LOG() << "Hello" << std::string(", world!") << dycore::logger::endl;
      *  // Results in:
-     *  // [21:03:08.753] Hello, world!
+     *  // [21:03:08.753 T0] Hello, world!
      * @endcode
      *
      * @ingroup DycoreUnittestCoreLibrary
@@ -49,13 +79,13 @@ namespace gt_verification {
      */
     enum class logger_action {
         nop,   /**< Do nothing */
-        flush, /**< Flush log stream */
-        endl,  /**< Insert a newline character and flush log stream */
+        flush, /**< Hand the current message to the background thread */
+        endl,  /**< Insert a newline character and hand the message to the background thread */
         newlog /**< Indicate if this is the first formatting operation on this log */
     };
 
     /**
-     * @brief Trivial Logger
+     * @brief Asynchronous Logger
      * @ingroup Logger
      */
     class logger : private boost::noncopyable /* singleton */
@@ -66,14 +96,22 @@ namespace gt_verification {
         /**
          * @brief Return the instance of the Logger
          */
-        static logger &getInstance();
+        static logger &getInstance() {
+            logger *instance = instance_.load(std::memory_order_acquire);
+            return instance ? *instance : create_instance();
+        }
+
+        /**
+         * @brief Check whether the logger is enabled
+         */
+        static bool enabled() noexcept { return getInstance().enable_.load(std::memory_order_relaxed); }
 
         /**
          * @brief Inserts data into the logging stream
          */
         template < class ValueType >
         logger &operator<<(const ValueType &value) noexcept {
-            if (enable_)
+            if (enable_.load(std::memory_order_relaxed))
                 this->logImpl(value);
             return (*this);
         }
@@ -82,16 +120,16 @@ namespace gt_verification {
          * @brief Inserts a special @c logger character to control the behaviour of the stream
          */
         logger &operator<<(const logger_action &loggerAction) noexcept {
-            if (enable_) {
+            if (enable_.load(std::memory_order_relaxed)) {
+                thread_state &state = local_state();
                 logger_action loggerSwitch =
-                    (loggerAction == logger_action::newlog && !flushed_) ? logger_action::endl : loggerAction;
+                    (loggerAction == logger_action::newlog && !state.flushed) ? logger_action::endl : loggerAction;
 
                 switch (loggerSwitch) {
                 case logger_action::endl:
-                    outStream_.put(outStream_.widen('\n'));
+                    state.line.put('\n');
                 case logger_action::flush:
-                    outStream_.flush();
-                    flushed_ = true;
+                    commit(state);
                 case logger_action::nop:
                 default:
                     break;
@@ -100,48 +138,148 @@ namespace gt_verification {
             return (*this);
         }
 
-        void enable() { enable_ = true; }
+        void enable();
         void disable() { enable_ = false; }
 
+        /**
+         * @brief Write the log to the file @c path (an empty path selects standard error)
+         *
+         * @throw verification_exception    The file cannot be opened
+         */
+        void set_sink(const std::string &path);
+
+        /**
+         * @brief Block until all messages handed to the background thread have been written
+         */
+        void sync();
+
+        /**
+         * @brief Number of messages dropped because a ring buffer was full
+         */
+        std::size_t num_dropped() const noexcept { return numDropped_; }
+
       private:
+        /// Per-thread message under construction and ring buffer
+        struct thread_state {
+            thread_state();
+            ~thread_state();
+
+            std::ostringstream line;
+            bool flushed;
+            int id;
+            std::shared_ptr< log_ring_buffer > buffer;
+
+            std::time_t second; ///< Second of the cached time
+            char time[13];      ///< Cached time "[HH:MM:SS.mmm" (the milliseconds are updated for every message)
+            std::string tag;    ///< Thread id " T<id>] "
+        };
+
+        static logger &create_instance();
+        static thread_state &local_state();
+
         template < class ValueType >
         void logImpl(const ValueType &value) noexcept {
-            if (flushed_) {
-                // Get current date-time (up to ms accuracy)
-                std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-                auto now_ms = now.time_since_epoch();
-                auto now_sec = std::chrono::duration_cast< std::chrono::seconds >(now_ms);
-                auto tm_ms = std::chrono::duration_cast< std::chrono::milliseconds >(now_ms - now_sec);
-
-                std::time_t currentTime = std::chrono::system_clock::to_time_t(now);
-                struct tm *localTime = std::localtime(&currentTime);
-
-                outStream_ << boost::format("[%02i:%02i:%02i.%03i] ") % localTime->tm_hour % localTime->tm_min %
-                                  localTime->tm_sec % tm_ms.count();
-            }
-            outStream_ << value;
-            flushed_ = false;
+            thread_state &state = local_state();
+            if (state.flushed)
+                write_prefix(state);
+            state.line << value;
+            state.flushed = false;
         }
 
+        /// Write the current time (up to ms accuracy) and the thread id to the message of @c state
+        static void write_prefix(thread_state &state) noexcept;
+
+        /// Hand the message of @c state to the background thread
+        void commit(thread_state &state) noexcept;
+
+        void start_writer();
+        void stop_writer();
+        void run_writer();
+
+        /// Whether the background thread runs in this process (the messages of a forked child are not written)
+        bool owns_writer() const noexcept;
+        void drain();
+
       private:
-        bool enable_;
-        int flushed_;
-        std::ostream &outStream_;
+        std::atomic< bool > enable_;
+        std::atomic< std::size_t > numDropped_;
+
+        // Ring buffers of all threads (including exited ones until they are drained)
+        std::mutex buffersMutex_;
+        std::vector< std::shared_ptr< log_ring_buffer > > buffers_;
+        int numThreads_;
+
+        // Background thread
+        std::thread writer_;
+        std::mutex writerMutex_;
+        std::condition_variable wakeWriter_;
+        std::condition_variable synced_;
+        std::atomic< bool > pending_;
+        bool stop_;
+        std::size_t syncRequested_;
+        std::size_t syncCompleted_;
+        pid_t writerPid_;
+
+        std::mutex sinkMutex_;
+        std::FILE *sink_;
+        std::size_t numDroppedReported_;
+
+        static std::atomic< logger * > instance_;
+    };
 
-        static logger *instance_;
+    /**
+     * @brief Turn the logger expression of VERIFICATION_LOG_AT() into a void expression
+     * @ingroup Logger
+     */
+    struct logger_voidify {
+        void operator&(const logger &) const noexcept {}
     };
 
+/**
+ * @def VERIFICATION_LOG_AT
+ * @brief Invoke the Logger if @c level is compiled in and the logger is enabled
+ *
+ * The expression is a conditional operator, i.e. the stream arguments are not evaluated otherwise. As `&` binds
+ * weaker than `<<`, all arguments following the macro are part of the logged expression.
+ *
+ * @ingroup Logger
+ */
+#define VERIFICATION_LOG_AT(level)                                                                                     \
+    !((level) <= GT_VERIFICATION_LOG_LEVEL && ::gt_verification::logger::enabled())                                    \
+        ? (void)0                                                                                                      \
+        : ::gt_verification::logger_voidify() &                                                                        \
+              (::gt_verification::logger::getInstance() << ::gt_verification::logger_action::newlog)
+
 /**
  * @def VERIFICATION_LOG
  * @brief Invoke the Logger
  *
+ * The macro is the logger itself, i.e. it can be bound to a reference. Its arguments are always evaluated, use
+ * VERIFICATION_LOG_INFO() to skip them when the logger is disabled.
+ *
  * @code{.cpp}
  *  VERIFICATION_LOG() << "Hello " << "world!" << logger::endl;
  *  // Results in:
- *  // [21:03:08.753] Hello, world!
+ *  // [21:03:08.753 T0] Hello, world!
  * @endcode
  *
  * @ingroup Logger
  */
-#define VERIFICATION_LOG() (logger::getInstance() << logger_action::newlog)
+#define VERIFICATION_LOG() (::gt_verification::logger::getInstance() << ::gt_verification::logger_action::newlog)
+
+/**
+ * @def VERIFICATION_LOG_INFO
+ * @brief Invoke the Logger for messages (removed if GT_VERIFICATION_LOG_LEVEL is less than 1)
+ *
+ * @ingroup Logger
+ */
+#define VERIFICATION_LOG_INFO() VERIFICATION_LOG_AT(1)
+
+/**
+ * @def VERIFICATION_LOG_DEBUG
+ * @brief Invoke the Logger for detailed messages (removed if GT_VERIFICATION_LOG_LEVEL is less than 2)
+ *
+ * @ingroup Logger
+ */
+#define VERIFICATION_LOG_DEBUG() VERIFICATION_LOG_AT(2)
 }
@@ -0,0 +1,89 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include "../common.h"
+
+namespace gt_verification {
+
+    /**
+     * @brief Order of a loop nest over the dimensions (0 = i, 1 = j, 2 = k) of a field
+     *
+     * The nest is derived from the strides of a field such that the innermost loop runs along the dimension
+     * with the smallest stride (i.e. the unit-stride dimension of the storage layout). Dimensions with equal
+     * strides keep the canonical order k (outer), j, i (inner).
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class loop_nest {
+      public:
+        /**
+         * @brief Canonical nest k (outer), j, i (inner)
+         */
+        loop_nest() noexcept : dims_{{2, 1, 0}} {}
+
+        /**
+         * @brief Nest of a field with the given strides
+         */
+        loop_nest(int iStride, int jStride, int kStride) : dims_{{2, 1, 0}} {
+            const std::array< int, 3 > strides{{std::abs(iStride), std::abs(jStride), std::abs(kStride)}};
+            std::stable_sort(dims_.begin(), dims_.end(), [&](int a, int b) { return strides[a] > strides[b]; });
+        }
+
+        int outer() const noexcept { return dims_[0]; }
+        int middle() const noexcept { return dims_[1]; }
+        int inner() const noexcept { return dims_[2]; }
+
+        /**
+         * @brief Check if this is the canonical nest k, j, i
+         */
+        bool is_canonical() const noexcept { return dims_[0] == 2 && dims_[1] == 1 && dims_[2] == 0; }
+
+      private:
+        std::array< int, 3 > dims_;
+    };
+
+    /**
+     * @brief Invoke a functor for each row of the box [begin, end) along the innermost dimension of the nest
+     *
+     * The functor is invoked as `f(start, n)` where `start` is the (i, j, k) position of the first entry of
+     * the row and `n` is the length of the row. If @c tileSize is positive, the two outer loops are tiled
+     * with tiles of `tileSize x tileSize` rows, which keeps the working set small when a second field with
+     * a different layout is accessed in the same sweep.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    template < typename Functor >
+    void for_each_row(const std::array< int, 3 > &begin,
+        const std::array< int, 3 > &end,
+        const loop_nest &nest,
+        Functor &&f,
+        int tileSize = 0) {
+        const int o = nest.outer(), m = nest.middle(), in = nest.inner();
+        const int n = end[in] - begin[in];
+        if (n <= 0)
+            return;
+
+        const int oTile = tileSize > 0 ? tileSize : std::max(1, end[o] - begin[o]);
+        const int mTile = tileSize > 0 ? tileSize : std::max(1, end[m] - begin[m]);
+
+        std::array< int, 3 > start;
+        start[in] = begin[in];
+        for (int oo = begin[o]; oo < end[o]; oo += oTile)
+            for (int mm = begin[m]; mm < end[m]; mm += mTile)
+                for (start[o] = oo; start[o] < std::min(oo + oTile, end[o]); ++start[o])
+                    for (start[m] = mm; start[m] < std::min(mm + mTile, end[m]); ++start[m])
+                        f(static_cast< const std::array< int, 3 > & >(start), n);
+    }
+} // namespace gt_verification
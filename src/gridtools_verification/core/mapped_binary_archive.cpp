@@ -0,0 +1,140 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "mapped_binary_archive.h"
+#include "logger.h"
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pt = boost::property_tree;
+
+namespace gt_verification {
+
+    /**
+     * Private read-only mapping of a whole file
+     */
+    class mapped_binary_archive::mapped_file : private boost::noncopyable {
+      public:
+        mapped_file(const std::string &filename) : data_(nullptr), size_(0) {
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+
+            struct stat fileStat;
+            if (::fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+                // Writable but private: the views over the mapping hand out mutable references
+                void *addr = ::mmap(nullptr, fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    data_ = static_cast< char * >(addr);
+                    size_ = fileStat.st_size;
+                }
+            }
+            ::close(fd);
+        }
+
+        ~mapped_file() {
+            if (data_)
+                ::munmap(data_, size_);
+        }
+
+        const char *data() const noexcept { return data_; }
+        std::size_t size() const noexcept { return size_; }
+
+      private:
+        char *data_;
+        std::size_t size_;
+    };
+
+    std::shared_ptr< mapped_binary_archive > mapped_binary_archive::open(
+        const std::string &directory, const std::string &prefix) {
+        std::shared_ptr< mapped_binary_archive > archive(new mapped_binary_archive(directory, prefix));
+
+        try {
+            pt::ptree metaData, archiveMetaData;
+            pt::read_json(directory + "/MetaData-" + prefix + ".json", metaData);
+
+            if (metaData.get< std::string >("archive_name") != "Binary")
+                return nullptr;
+
+            pt::read_json(directory + "/ArchiveMetaData-" + prefix + ".json", archiveMetaData);
+
+            for (const auto &savepoint : metaData.get_child("savepoint_vector.fields_per_savepoint")) {
+                archive->fieldsPerSavepoint_.emplace_back();
+                for (const auto &field : savepoint.second)
+                    archive->fieldsPerSavepoint_.back()[field.first] = field.second.get_value< int >();
+            }
+
+            // Each entry of the table is a pair [offset, checksum]
+            for (const auto &field : archiveMetaData.get_child("fields_table")) {
+                auto &offsets = archive->offsets_[field.first];
+                for (const auto &entry : field.second)
+                    offsets.push_back(entry.second.begin()->second.get_value< std::size_t >());
+            }
+        } catch (pt::ptree_error &e) {
+            VERIFICATION_LOG() << "Cannot map archive '" << prefix << "': " << e.what() << logger_action::endl;
+            return nullptr;
+        }
+
+        return archive;
+    }
+
+    mapped_binary_archive::mapped_binary_archive(const std::string &directory, const std::string &prefix)
+        : directory_(directory), prefix_(prefix) {}
+
+    std::shared_ptr< mapped_binary_archive::mapped_file > mapped_binary_archive::file(const std::string &name) {
+        std::lock_guard< std::mutex > lock(mutex_);
+
+        auto &file = files_[name];
+        if (!file)
+            file = std::make_shared< mapped_file >(directory_ + "/" + prefix_ + "_" + name + ".dat");
+        return file;
+    }
+
+    std::shared_ptr< const char > mapped_binary_archive::data(
+        const std::string &name, int savepointIndex, std::size_t bytes) {
+        if (savepointIndex < 0 || savepointIndex >= (int)fieldsPerSavepoint_.size())
+            return nullptr;
+
+        const auto &fields = fieldsPerSavepoint_[savepointIndex];
+        auto fieldIt = fields.find(name);
+        auto offsetsIt = offsets_.find(name);
+        if (fieldIt == fields.end() || offsetsIt == offsets_.end() || fieldIt->second < 0 ||
+            fieldIt->second >= (int)offsetsIt->second.size())
+            return nullptr;
+
+        const std::size_t offset = offsetsIt->second[fieldIt->second];
+        auto mappedFile = file(name);
+        if (!mappedFile->data() || offset + bytes > mappedFile->size())
+            return nullptr;
+
+        // The returned pointer shares the ownership of the mapping
+        return std::shared_ptr< const char >(mappedFile, mappedFile->data() + offset);
+    }
+
+    void mapped_binary_archive::release(const void *data, std::size_t bytes) noexcept {
+        if (!data || bytes == 0)
+            return;
+
+        static const std::uintptr_t pageSize = ::sysconf(_SC_PAGESIZE);
+        // Pages only partially covered by the range may hold data of neighbouring slabs or fields which is still in
+        // use (and possibly modified), hence only the pages entirely inside the range are released
+        const std::uintptr_t begin = reinterpret_cast< std::uintptr_t >(data);
+        const std::uintptr_t first = (begin + pageSize - 1) & ~(pageSize - 1);
+        const std::uintptr_t last = (begin + bytes) & ~(pageSize - 1);
+        if (first >= last)
+            return;
+        ::madvise(reinterpret_cast< void * >(first), last - first, MADV_DONTNEED);
+    }
+} // namespace gt_verification
@@ -0,0 +1,86 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gt_verification {
+
+    /**
+     * @brief Read-only access to the data files of a Serialbox "Binary" archive through memory mappings
+     *
+     * The offsets of the fields are taken from the meta-data files (`MetaData-<prefix>.json` and
+     * `ArchiveMetaData-<prefix>.json`) of the archive. The data files (`<prefix>_<field>.dat`) are mapped on
+     * first access and stay mapped as long as the archive or any pointer returned by data() is alive.
+     * The mappings are private: the pages are shared with the page cache and only become private memory
+     * if they are written to.
+     *
+     * A field is stored contiguously with the first dimension running fastest, i.e with the strides
+     * `(1, isize, isize * jsize)`.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class mapped_binary_archive : private boost::noncopyable {
+      public:
+        /**
+         * @brief Open the archive with the given prefix in @c directory
+         *
+         * @return The archive or @c nullptr if it is not a Binary archive or its meta-data cannot be read
+         */
+        static std::shared_ptr< mapped_binary_archive > open(const std::string &directory, const std::string &prefix);
+
+        /**
+         * @brief Get the data of the field @c name at the savepoint with index @c savepointIndex
+         *
+         * The index refers to the order of the savepoints of the serializer.
+         *
+         * @param name              Name of the field
+         * @param savepointIndex    Index of the savepoint
+         * @param bytes             Size of the field in bytes
+         * @return Pointer to the first byte of the field or @c nullptr if the field is not stored at the
+         *         savepoint or the data file is too small
+         */
+        std::shared_ptr< const char > data(const std::string &name, int savepointIndex, std::size_t bytes);
+
+        /**
+         * @brief Release the pages of a mapping returned by data() which cover [data, data + bytes)
+         *
+         * Only the pages entirely inside the range are released, hence a range smaller than a page releases nothing.
+         * The pages are dropped from the memory of the process and are read again from the page cache on the next
+         * access, i.e. anything written to them is lost.
+         */
+        static void release(const void *data, std::size_t bytes) noexcept;
+
+      private:
+        mapped_binary_archive(const std::string &directory, const std::string &prefix);
+
+        class mapped_file;
+        std::shared_ptr< mapped_file > file(const std::string &name);
+
+        std::string directory_;
+        std::string prefix_;
+
+        /// Index of each field in the offset table per savepoint
+        std::vector< std::map< std::string, int > > fieldsPerSavepoint_;
+
+        /// Byte offsets of the stored fields in the data files
+        std::map< std::string, std::vector< std::size_t > > offsets_;
+
+        std::mutex mutex_;
+        std::map< std::string, std::shared_ptr< mapped_file > > files_;
+    };
+} // namespace gt_verification
@@ -0,0 +1,82 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "../common.h"
+#include "thread_pool.h"
+
+namespace gt_verification {
+
+    /**
+     * @brief Number of threads supported by the hardware (at least 1)
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    inline int hardware_threads() noexcept {
+        return std::max(1, static_cast< int >(std::thread::hardware_concurrency()));
+    }
+
+    /**
+     * @brief Number of blocks the range [begin, end) is split into by parallel_for_blocks()
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    inline int num_blocks(int begin, int end, int numThreads) noexcept {
+        return std::max(1, std::min(end - begin, numThreads));
+    }
+
+    /**
+     * @brief Split the range [begin, end) into contiguous blocks and process each block on its own thread
+     *
+     * The functor is invoked as `f(block, blockBegin, blockEnd)` where the blocks are numbered in ascending
+     * order of the range, i.e results stored per block can be merged in a deterministic order. The blocks are
+     * processed by the calling thread and the workers of the thread_pool, which are created once and reused
+     * by all calls. If a worker cannot be spawned, its block is processed by the calling thread as well. The
+     * first exception thrown by any of the blocks is rethrown after all blocks have been processed.
+     *
+     * @param begin         Start of the range
+     * @param end           End of the range (exclusive)
+     * @param numThreads    Maximum number of threads to use
+     * @param f             Functor to invoke for each block
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    template < typename Functor >
+    void parallel_for_blocks(int begin, int end, int numThreads, Functor &&f) {
+        const int numBlocks = num_blocks(begin, end, numThreads);
+        if (numBlocks == 1) {
+            f(0, begin, end);
+            return;
+        }
+
+        const int size = end - begin;
+        auto blockBegin = [&](int block) { return begin + static_cast< int >((long)size * block / numBlocks); };
+
+        std::vector< std::exception_ptr > exceptions(numBlocks);
+        auto runBlock = [&](int block) {
+            try {
+                f(block, blockBegin(block), blockBegin(block + 1));
+            } catch (...) {
+                exceptions[block] = std::current_exception();
+            }
+        };
+
+        thread_pool::get_instance().run(numBlocks, runBlock);
+
+        for (auto &exception : exceptions)
+            if (exception)
+                std::rethrow_exception(exception);
+    }
+} // namespace gt_verification
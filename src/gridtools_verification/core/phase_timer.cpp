@@ -0,0 +1,126 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "phase_timer.h"
+#include "../verification_exception.h"
+#include "color.h"
+#include <algorithm>
+
+namespace gt_verification {
+
+    phase_statistics &phase_statistics::get_instance() {
+        // The initialization of a local static is thread-safe, the instance is never destroyed
+        static phase_statistics *instance = new phase_statistics;
+        return (*instance);
+    }
+
+    phase_statistics::phase_statistics() : enabled_(false) {}
+
+    void phase_statistics::set_scope_function(std::function< std::string() > scopeFunction) {
+        std::lock_guard< std::mutex > lock(mutex_);
+        scopeFunction_ = scopeFunction;
+    }
+
+    std::string phase_statistics::current_scope() const {
+        std::function< std::string() > scopeFunction;
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            scopeFunction = scopeFunction_;
+        }
+        return scopeFunction ? scopeFunction() : std::string();
+    }
+
+    void phase_statistics::add(const std::string &scope, const std::string &phase, double seconds, std::size_t bytes) {
+        std::lock_guard< std::mutex > lock(mutex_);
+
+        auto scopeIt = std::find_if(scopes_.begin(),
+            scopes_.end(),
+            [&](const std::pair< std::string, std::vector< struct phase > > &entry) { return entry.first == scope; });
+        if (scopeIt == scopes_.end())
+            scopeIt = scopes_.insert(scopes_.end(), std::make_pair(scope, std::vector< struct phase >()));
+
+        auto &phases = scopeIt->second;
+        auto phaseIt = std::find_if(
+            phases.begin(), phases.end(), [&](const struct phase &entry) { return entry.name == phase; });
+        if (phaseIt == phases.end())
+            phaseIt = phases.insert(phases.end(), {phase, 0, 0, 0});
+
+        ++phaseIt->count;
+        phaseIt->seconds += seconds;
+        phaseIt->bytes += bytes;
+    }
+
+    std::vector< std::string > phase_statistics::scopes() const {
+        std::lock_guard< std::mutex > lock(mutex_);
+        std::vector< std::string > scopes;
+        for (const auto &entry : scopes_)
+            scopes.push_back(entry.first);
+        return scopes;
+    }
+
+    std::vector< phase_statistics::phase > phase_statistics::phases(const std::string &scope) const {
+        std::lock_guard< std::mutex > lock(mutex_);
+        for (const auto &entry : scopes_)
+            if (entry.first == scope)
+                return entry.second;
+        return std::vector< phase >();
+    }
+
+    void phase_statistics::print(std::FILE *stream) const {
+        std::lock_guard< std::mutex > lock(mutex_);
+        if (scopes_.empty())
+            return;
+
+        std::fprintf(stream, "%-13s%-26s %8s %12s %12s %10s\n", "", "Phase", "Count", "Time [s]", "Data [MB]", "GB/s");
+        for (const auto &entry : scopes_) {
+            cfprintf(stream, color::GREEN, "[  TIMING  ]");
+            std::fprintf(stream, " %s\n", entry.first.empty() ? "(no test)" : entry.first.c_str());
+
+            for (const auto &phase : entry.second) {
+                std::fprintf(stream,
+                    "%-13s%-26s %8zu %12.4f %12.2f",
+                    "",
+                    phase.name.c_str(),
+                    phase.count,
+                    phase.seconds,
+                    phase.bytes / double(1 << 20));
+                if (phase.bytes > 0)
+                    std::fprintf(stream, " %10.3f\n", phase.gigabytes_per_second());
+                else
+                    std::fprintf(stream, " %10s\n", "-");
+            }
+        }
+    }
+
+    void phase_statistics::write_csv(const std::string &path) const {
+        std::FILE *file = std::fopen(path.c_str(), "w");
+        if (!file)
+            throw verification_exception("cannot open the timing file '%s'", path);
+
+        std::lock_guard< std::mutex > lock(mutex_);
+        std::fprintf(file, "scope,phase,count,seconds,bytes,gb_per_s\n");
+        for (const auto &entry : scopes_)
+            for (const auto &phase : entry.second)
+                std::fprintf(file,
+                    "%s,%s,%zu,%.9g,%zu,%.9g\n",
+                    entry.first.c_str(),
+                    phase.name.c_str(),
+                    phase.count,
+                    phase.seconds,
+                    phase.bytes,
+                    phase.gigabytes_per_second());
+        std::fclose(file);
+    }
+
+    void phase_statistics::clear() {
+        std::lock_guard< std::mutex > lock(mutex_);
+        scopes_.clear();
+    }
+} // namespace gt_verification
@@ -0,0 +1,177 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gt_verification {
+
+    /**
+     * @brief Process-wide wall time and data volume of named phases, accumulated per scope
+     *
+     * The phases are measured by phase_timer and accumulated in the scope returned by the scope function at the
+     * start of each timer (e.g. the name of the running test, see unittest_environment). The statistics are
+     * disabled by default, in which case the timers do nothing.
+     *
+     * Phases may be nested (e.g. `serialization::load` within `load_iteration`) and the time of phases measured
+     * on several threads at once is summed up.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class phase_statistics : private boost::noncopyable /* singleton */
+    {
+        phase_statistics();
+
+      public:
+        /**
+         * @brief Accumulated measurements of a phase
+         */
+        struct phase {
+            std::string name;
+            std::size_t count;  ///< Number of measurements
+            double seconds;     ///< Wall time
+            std::size_t bytes;  ///< Data volume
+
+            /**
+             * @brief Throughput in GB/s (0 if no data was processed)
+             */
+            double gigabytes_per_second() const noexcept {
+                return (bytes > 0 && seconds > 0) ? bytes / seconds * 1e-9 : 0;
+            }
+        };
+
+        /**
+         * @brief Return the instance of the statistics
+         */
+        static phase_statistics &get_instance();
+
+        /**
+         * @brief Enable or disable the measurement of phases
+         */
+        void enable(bool enabled = true) noexcept { enabled_ = enabled; }
+
+        /**
+         * @brief Check whether phases are measured
+         */
+        bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Set the function returning the scope in which the phases are accumulated
+         */
+        void set_scope_function(std::function< std::string() > scopeFunction);
+
+        /**
+         * @brief Get the current scope (empty if no scope function is set)
+         */
+        std::string current_scope() const;
+
+        /**
+         * @brief Add a measurement of @c phase to @c scope
+         */
+        void add(const std::string &scope, const std::string &phase, double seconds, std::size_t bytes);
+
+        /**
+         * @brief Get the scopes in the order of their first measurement
+         */
+        std::vector< std::string > scopes() const;
+
+        /**
+         * @brief Get the phases of @c scope in the order of their first measurement
+         */
+        std::vector< phase > phases(const std::string &scope) const;
+
+        /**
+         * @brief Print a table of all phases to @c stream (nothing if no phase was measured)
+         */
+        void print(std::FILE *stream) const;
+
+        /**
+         * @brief Write all phases as CSV (`scope,phase,count,seconds,bytes,gb_per_s`) to the file @c path
+         *
+         * @throw verification_exception    The file cannot be opened
+         */
+        void write_csv(const std::string &path) const;
+
+        /**
+         * @brief Drop all measurements
+         */
+        void clear();
+
+      private:
+        std::atomic< bool > enabled_;
+
+        mutable std::mutex mutex_;
+        std::function< std::string() > scopeFunction_;
+        std::vector< std::pair< std::string, std::vector< phase > > > scopes_; ///< Few scopes and phases
+    };
+
+    /**
+     * @brief Measure the wall time of a phase during the lifetime of the timer (see phase_statistics)
+     *
+     * @code{.cpp}
+     *  {
+     *      phase_timer timer("verify", bytes);
+     *      // ...
+     *  } // The phase is added to phase_statistics
+     * @endcode
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class phase_timer : private boost::noncopyable {
+      public:
+        /**
+         * @brief Start measuring @c phase which processes @c bytes of data
+         */
+        explicit phase_timer(const char *phase, std::size_t bytes = 0)
+            : phase_(phase), bytes_(bytes), enabled_(phase_statistics::get_instance().enabled()) {
+            if (enabled_) {
+                scope_ = phase_statistics::get_instance().current_scope();
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        /**
+         * @brief Add the measurement to phase_statistics
+         */
+        ~phase_timer() {
+            if (enabled_)
+                phase_statistics::get_instance().add(scope_, phase_, seconds(), bytes_);
+        }
+
+        /**
+         * @brief Add @c bytes to the data volume of the phase
+         */
+        void add_bytes(std::size_t bytes) noexcept { bytes_ += bytes; }
+
+        /**
+         * @brief Elapsed wall time in seconds (0 if phase_statistics is disabled)
+         */
+        double seconds() const noexcept {
+            return enabled_ ? std::chrono::duration< double >(std::chrono::steady_clock::now() - start_).count() : 0;
+        }
+
+      private:
+        const char *phase_;
+        std::size_t bytes_;
+        bool enabled_;
+        std::string scope_;
+        std::chrono::steady_clock::time_point start_;
+    };
+} // namespace gt_verification
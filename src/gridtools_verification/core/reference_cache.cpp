@@ -0,0 +1,73 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "reference_cache.h"
+#include <cstdlib>
+
+namespace gt_verification {
+
+    reference_cache &reference_cache::get_instance() {
+        // The initialization of a local static is thread-safe, the instance is never destroyed
+        static reference_cache *instance = new reference_cache;
+        return (*instance);
+    }
+
+    reference_cache::reference_cache() : budget_(0), size_(0), hits_(0), misses_(0) {
+        // Check environment variable
+        const char *envCache = std::getenv("VERIFICATION_CACHE");
+        if (envCache && std::atoi(envCache) > 0)
+            budget_ = static_cast< std::size_t >(std::atoi(envCache)) << 20;
+    }
+
+    void reference_cache::set_budget(std::size_t bytes) {
+        std::lock_guard< std::mutex > lock(mutex_);
+        budget_ = bytes;
+        evict(budget_);
+    }
+
+    std::shared_ptr< char > reference_cache::find(const std::string &key) {
+        std::lock_guard< std::mutex > lock(mutex_);
+
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->data;
+    }
+
+    void reference_cache::insert(const std::string &key, std::shared_ptr< char > data, std::size_t bytes) {
+        std::lock_guard< std::mutex > lock(mutex_);
+
+        if (bytes > budget_ || index_.count(key))
+            return;
+
+        evict(budget_ - bytes);
+        entries_.push_front(entry{key, data, bytes});
+        index_[key] = entries_.begin();
+        size_ += bytes;
+    }
+
+    void reference_cache::clear() {
+        std::lock_guard< std::mutex > lock(mutex_);
+        evict(0);
+    }
+
+    void reference_cache::evict(std::size_t budget) {
+        while (size_ > budget) {
+            size_ -= entries_.back().bytes;
+            index_.erase(entries_.back().key);
+            entries_.pop_back();
+        }
+    }
+} // namespace gt_verification
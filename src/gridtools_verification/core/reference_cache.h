@@ -0,0 +1,115 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace gt_verification {
+
+    /**
+     * @brief Process-wide least recently used cache of loaded fields
+     *
+     * The cache holds the data of fields loaded by serialization::load() keyed by archive, field name and
+     * savepoint (see serialization). The least recently used entries are evicted if the cached data exceeds
+     * the memory budget. The cache is disabled (budget of 0) by default.
+     *
+     * The budget can be set by passing the command_line option `--cache=MB` or by setting the environment
+     * variable `VERIFICATION_CACHE` to the budget in megabytes.
+     *
+     * The cached buffers are shared and must not be modified. A buffer handed out by find() stays valid even
+     * if it is evicted in the meantime.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class reference_cache : private boost::noncopyable /* singleton */
+    {
+        reference_cache();
+
+      public:
+        /**
+         * @brief Return the instance of the cache
+         */
+        static reference_cache &get_instance();
+
+        /**
+         * @brief Set the memory budget in bytes (evicts entries if necessary, 0 disables the cache)
+         */
+        void set_budget(std::size_t bytes);
+
+        /**
+         * @brief Memory budget in bytes
+         */
+        std::size_t budget() const noexcept { return budget_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Check whether the cache is enabled
+         */
+        bool enabled() const noexcept { return budget() > 0; }
+
+        /**
+         * @brief Get the buffer stored under @c key (or @c nullptr) and mark it as most recently used
+         */
+        std::shared_ptr< char > find(const std::string &key);
+
+        /**
+         * @brief Store the buffer of @c bytes under @c key and evict the least recently used entries
+         *
+         * Buffers larger than the budget are not stored.
+         */
+        void insert(const std::string &key, std::shared_ptr< char > data, std::size_t bytes);
+
+        /**
+         * @brief Drop all entries
+         */
+        void clear();
+
+        /**
+         * @brief Bytes held by the cache
+         */
+        std::size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Number of successful find() calls
+         */
+        std::size_t hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Number of unsuccessful find() calls
+         */
+        std::size_t misses() const noexcept { return misses_.load(std::memory_order_relaxed); }
+
+      private:
+        struct entry {
+            std::string key;
+            std::shared_ptr< char > data;
+            std::size_t bytes;
+        };
+
+        void evict(std::size_t budget);
+
+        std::mutex mutex_;
+        std::list< entry > entries_; ///< Most recently used first
+        std::unordered_map< std::string, std::list< entry >::iterator > index_;
+
+        // Modified under the mutex, but read without it by the accessors
+        std::atomic< std::size_t > budget_;
+        std::atomic< std::size_t > size_;
+        std::atomic< std::size_t > hits_;
+        std::atomic< std::size_t > misses_;
+    };
+} // namespace gt_verification
@@ -0,0 +1,46 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "savepoint_index.h"
+#include <algorithm>
+
+namespace gt_verification {
+
+    savepoint_index::savepoint_index(const ser::serializer &serializer) : savepoints_(serializer.savepoints()) {
+        for (int position = 0; position < (int)savepoints_.size(); ++position)
+            positions_[savepoints_[position].name()].push_back(position);
+    }
+
+    const std::vector< int > &savepoint_index::positions(const std::string &name) const noexcept {
+        static const std::vector< int > none;
+        auto it = positions_.find(name);
+        return it != positions_.end() ? it->second : none;
+    }
+
+    const std::vector< std::pair< int, int > > &savepoint_index::pairs(
+        const std::string &inSavepointName, const std::string &outSavepointName) {
+        std::lock_guard< std::mutex > lock(mutex_);
+
+        auto inserted = pairs_.emplace(
+            std::make_pair(inSavepointName, outSavepointName), std::vector< std::pair< int, int > >());
+        auto &result = inserted.first->second;
+        if (!inserted.second)
+            return result;
+
+        const std::vector< int > &inPositions = positions(inSavepointName);
+        for (int outPosition : positions(outSavepointName)) {
+            // Closest input savepoint before the output savepoint
+            auto it = std::lower_bound(inPositions.begin(), inPositions.end(), outPosition);
+            if (it != inPositions.begin())
+                result.emplace_back(*std::prev(it), outPosition);
+        }
+        return result;
+    }
+} // namespace gt_verification
@@ -0,0 +1,72 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include "serialization.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gt_verification {
+
+    /**
+     * @brief Index of the savepoints of a serializer by name
+     *
+     * The index stores the positions of the savepoints of each name in ascending order. Pairs of input and
+     * output savepoints are computed once per pair of names with a binary search per output savepoint.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class savepoint_index : private boost::noncopyable {
+      public:
+        /**
+         * @brief Build the index of the savepoints of @c serializer
+         */
+        savepoint_index(const ser::serializer &serializer);
+
+        /**
+         * @brief Positions of the savepoints with name @c name in ascending order
+         */
+        const std::vector< int > &positions(const std::string &name) const noexcept;
+
+        /**
+         * @brief Positions of the pairs of input and output savepoints
+         *
+         * For each savepoint named @c outSavepointName, the closest preceding savepoint named
+         * @c inSavepointName forms a pair. Output savepoints without preceding input savepoint are skipped.
+         *
+         * @return Pairs of (input, output) positions in ascending order of the output savepoints
+         */
+        const std::vector< std::pair< int, int > > &pairs(
+            const std::string &inSavepointName, const std::string &outSavepointName);
+
+        /**
+         * @brief Savepoint at @c position
+         */
+        const ser::savepoint &savepoint(int position) const noexcept { return savepoints_[position]; }
+
+        /**
+         * @brief Number of savepoints
+         */
+        int size() const noexcept { return savepoints_.size(); }
+
+      private:
+        std::vector< ser::savepoint > savepoints_;
+        std::unordered_map< std::string, std::vector< int > > positions_;
+
+        std::mutex mutex_;
+        std::map< std::pair< std::string, std::string >, std::vector< std::pair< int, int > > > pairs_;
+    };
+} // namespace gt_verification
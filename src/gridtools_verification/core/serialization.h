@@ -15,9 +15,18 @@
 #include "command_line.h"
 #include "error.h"
 #include "logger.h"
+#include "mapped_binary_archive.h"
+#include "phase_timer.h"
+#include "reference_cache.h"
 #include "type_erased_field.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <serialbox/core/frontend/gridtools/Serializer.h>
+#include <sstream>
 #include <string>
 
 namespace gt_verification {
@@ -27,7 +36,11 @@ namespace gt_verification {
     /**
      * @brief Load and store GridTools fields from disk
      *
-     * This is a wrapper around Serialbox.
+     * This is a wrapper around Serialbox. The Serialbox serializers are not thread-safe, hence all calls to a
+     * serializer are serialized by a mutex which is shared by all serialization objects of this serializer, and
+     * load() can be invoked concurrently for different fields. Calls to different serializers (e.g. loading the
+     * reference data while the error_writer writes in the background) do not wait for each other.
+     * Loaded fields are kept in the reference_cache (if enabled), repeated loads only copy the cached data.
      *
      * @ingroup DycoreUnittestCoreLibrary
      */
@@ -35,8 +48,18 @@ namespace gt_verification {
       public:
         /**
          * @brief Initialize the Serialization object with a reference serializer
+         *
+         * If the memory mapped Binary archive of the serializer is given, the fields are read directly from
+         * the mapping and can be mapped without copying them (see map()).
+         */
+        serialization(std::shared_ptr< ser::serializer > serializer,
+            std::shared_ptr< mapped_binary_archive > archive = nullptr)
+            : serializer_(serializer), archive_(archive), mutex_(serializer_mutex(serializer.get())) {}
+
+        /**
+         * @brief Lock the serializer, e.g. to call it directly while other threads use it through serialization
          */
-        serialization(std::shared_ptr< ser::serializer > serializer) : serializer_(serializer) {}
+        std::unique_lock< std::mutex > lock() const { return std::unique_lock< std::mutex >(*mutex_); }
 
         /**
          * @brief Load the a field and store it in the provided field
@@ -46,6 +69,7 @@ namespace gt_verification {
          * @param name      Name of the desired field
          * @param field     Field in which the data is going to be loaded to
          * @param savepoint Savepoint to load from
+         * @param position  Position of @c savepoint in the serializer (looked up if negative, see savepoint_index)
          *
          * @throw Exception The provided field does not match the requested one.
          * @{
@@ -54,18 +78,26 @@ namespace gt_verification {
         void load(const std::string &name,
             FieldType &field,
             const ser::savepoint &savepoint,
-            const bool also_previous = false) {
-            this->load(
-                name, type_erased_field_view< typename FieldType::storage_t::data_t >(field), savepoint, also_previous);
+            const bool also_previous = false,
+            int position = -1) {
+            this->load(name,
+                type_erased_field_view< typename FieldType::storage_t::data_t >(field),
+                savepoint,
+                also_previous,
+                position);
         }
 
         template < typename T >
         void load(const std::string &name,
             type_erased_field_view< T > field,
             const ser::savepoint &savepoint,
-            const bool also_previous = false) {
+            const bool also_previous = false,
+            int position = -1) {
+            phase_timer timer("serialization::load", sizeof(T) * std::size_t(field.size()));
             field.sync();
 
+            std::unique_lock< std::mutex > lock(*mutex_);
+
             // Get info of serialized field
             const ser::field_meta_info &info = serializer_->get_field_meta_info(name);
 
@@ -79,8 +111,8 @@ namespace gt_verification {
                 mask[0] = true;
             }
 
-            VERIFICATION_LOG() << boost::format(" - loading %-15s (%s)") % name % to_string(field_sizes)
-                               << logger_action::endl;
+            VERIFICATION_LOG_DEBUG() << boost::format(" - loading %-15s (%s)") % name % to_string(field_sizes)
+                                     << logger_action::endl;
 
             // Check dimensions
             if (!sizes_compatible(info.dims(), field_sizes))
@@ -96,15 +128,99 @@ namespace gt_verification {
                 throw verification_exception(
                     "the requested field '%s' has a different type than the provided field.", name);
 
-            // Deserialize field
-            auto strides = apply_mask(mask, {field.i_stride(), field.j_stride(), field.k_stride()});
-            serializer_->read(name, savepoint, field.data(), strides, also_previous);
+            // Fields stored as a whole can be copied from the mapped archive or the reference cache
+            const bool wholeField = !also_previous && field_sizes.size() == 3 && info.dims().size() >= 3 &&
+                                    std::equal(field_sizes.begin(), field_sizes.end(), info.dims().begin());
+            const std::array< int, 3 > sizes =
+                wholeField ? std::array< int, 3 >{{field_sizes[0], field_sizes[1], field_sizes[2]}}
+                           : std::array< int, 3 >{{0, 0, 0}};
+
+            // The page cache already holds the mapped archive, hence mapped fields are not cached
+            std::shared_ptr< T > mapped =
+                wholeField ? mapped_data< T >(name, savepoint, position, info.dims()) : nullptr;
+            reference_cache &cache = reference_cache::get_instance();
+            const bool cacheable = wholeField && !mapped && cache.enabled();
+            const std::string key = cacheable ? cache_key(name, savepoint) : std::string();
+            std::shared_ptr< char > cached = cacheable ? cache.find(key) : nullptr;
+
+            if (mapped) {
+                lock.unlock();
+                copy_field(type_erased_field< T >(mapped, name, sizes, archive_strides(sizes)).to_view(), field);
+            } else if (cached) {
+                lock.unlock();
+                copy_field(archive_field< T >(cached, name, sizes).to_view(), field);
+            } else {
+                auto strides = apply_mask(mask, {field.i_stride(), field.j_stride(), field.k_stride()});
+                serializer_->read(name, savepoint, field.data(), strides, also_previous);
+                lock.unlock();
+
+                if (cacheable) {
+                    const std::size_t bytes = sizeof(T) * sizes[0] * sizes[1] * sizes[2];
+                    std::shared_ptr< char > buffer(new char[bytes], std::default_delete< char[] >());
+                    copy_field(field, archive_field< T >(buffer, name, sizes).to_view());
+                    cache.insert(key, buffer, bytes);
+                }
+            }
 
             field.sync();
         }
 
         /** @} */
 
+        /**
+         * @brief Replace @c field by a field over the mapped archive holding @c name at @c savepoint
+         *
+         * No data is copied and the field only occupies the pages of the page cache. This requires a mapped
+         * Binary archive and a field with the layout of the archive, i.e the strides `(1, isize, isize * jsize)`,
+         * unless @c anyLayout is set in which case the returned field has the layout of the archive. Writing to
+         * the returned field does not modify the archive.
+         *
+         * The @c position of @c savepoint in the serializer is looked up if it is negative. Only fields serialized
+         * with exactly the sizes of @c field are mapped.
+         *
+         * @note Unlike reading through Serialbox, mapping does not validate the checksum of the field stored in the
+         * archive meta-data, hence a corrupted archive is not detected.
+         *
+         * @return @c true if the field has been mapped, otherwise @c field is not modified
+         */
+        template < typename T >
+        bool map(const std::string &name,
+            const ser::savepoint &savepoint,
+            type_erased_field< T > &field,
+            bool anyLayout = false,
+            int position = -1) {
+            const std::array< int, 3 > sizes{{field.i_size(), field.j_size(), field.k_size()}};
+            const std::array< int, 3 > strides = archive_strides(sizes);
+            if (!archive_ || (!anyLayout && (field.i_stride() != strides[0] || field.j_stride() != strides[1] ||
+                                                field.k_stride() != strides[2])))
+                return false;
+
+            std::shared_ptr< T > mapped;
+            try {
+                std::lock_guard< std::mutex > lock(*mutex_);
+
+                const ser::field_meta_info &info = serializer_->get_field_meta_info(name);
+                // The serialized sizes must match exactly, a (D-1)-dimensional field is not mapped onto a D-dimensional
+                // one as the archive holds less data
+                const std::vector< int > &dims = info.dims();
+                if (info.type() != serialbox::ToTypeID< T >::value || dims.size() < 3 ||
+                    !std::equal(sizes.begin(), sizes.end(), dims.begin()))
+                    return false;
+
+                mapped = mapped_data< T >(name, savepoint, position, dims);
+                if (!mapped)
+                    return false;
+
+                VERIFICATION_LOG_DEBUG() << boost::format(" - mapping %-15s (%s)") % name % to_string(info.dims())
+                                         << logger_action::endl;
+            } catch (ser::exception &) {
+                return false;
+            }
+
+            field = type_erased_field< T >(mapped, name, sizes, strides);
+            return true;
+        }
+
         /**
          * @brief Serializes a data field at given savepoint
          *
@@ -126,6 +242,8 @@ namespace gt_verification {
 
         template < typename T >
         void write(std::string name, type_erased_field_view< T > field, const ser::savepoint &savepoint) {
+            phase_timer timer("serialization::write", sizeof(T) * std::size_t(field.size()));
+
             // Make sure data is on the Host
             field.sync();
 
@@ -136,7 +254,7 @@ namespace gt_verification {
             int jSize = field.j_size();
             int kSize = field.k_size();
 
-            VERIFICATION_LOG() << boost::format("Serializing '%s'") % name << logger_action::endl;
+            VERIFICATION_LOG_DEBUG() << boost::format("Serializing '%s'") % name << logger_action::endl;
 
             int iStride = field.i_stride();
             int jStride = field.j_stride();
@@ -150,6 +268,8 @@ namespace gt_verification {
             auto typeID = serialbox::ToTypeID< T >::value;
 
             try {
+                std::lock_guard< std::mutex > lock(*mutex_);
+
                 // Register field
                 serializer_->register_field(name, typeID, std::vector< int >{iSize, jSize, kSize});
 
@@ -169,6 +289,77 @@ namespace gt_verification {
 
       private:
         std::shared_ptr< ser::serializer > serializer_;
+        std::shared_ptr< mapped_binary_archive > archive_;
+        std::shared_ptr< std::mutex > mutex_; ///< Guards all calls to the serializer
+
+        /// Strides of a field in the Binary archive (the first dimension runs fastest)
+        static std::array< int, 3 > archive_strides(const std::array< int, 3 > &sizes) noexcept {
+            return {{1, sizes[0], sizes[0] * sizes[1]}};
+        }
+
+        /// Field over a buffer with the layout of the Binary archive
+        template < typename T >
+        static type_erased_field< T > archive_field(
+            std::shared_ptr< char > buffer, const std::string &name, const std::array< int, 3 > &sizes) {
+            return type_erased_field< T >(std::shared_ptr< T >(buffer, reinterpret_cast< T * >(buffer.get())),
+                name,
+                sizes,
+                archive_strides(sizes));
+        }
+
+        /// Key of the field @c name at @c savepoint in the reference cache
+        std::string cache_key(const std::string &name, const ser::savepoint &savepoint) const {
+            std::ostringstream key;
+            key << serializer_->directory() << "/" << serializer_->prefix() << ":" << name << "@" << savepoint;
+            return key.str();
+        }
+
+        /**
+         * Data of the 3D field @c name at @c savepoint in the mapped archive or @c nullptr if it is not available
+         * (must be called with the serializer mutex locked)
+         *
+         * The @c position of @c savepoint in the serializer is only searched for if it is negative.
+         */
+        template < typename T >
+        std::shared_ptr< T > mapped_data(
+            const std::string &name, const ser::savepoint &savepoint, int position, const std::vector< int > &dims) {
+            if (!archive_ || dims.size() < 3 ||
+                std::any_of(dims.begin(), dims.begin() + 3, [](int size) { return size < 1; }) ||
+                std::any_of(dims.begin() + 3, dims.end(), [](int size) { return size > 1; }))
+                return nullptr;
+
+            if (position < 0) {
+                const std::vector< ser::savepoint > &savepoints = serializer_->savepoints();
+                auto it = std::find(savepoints.begin(), savepoints.end(), savepoint);
+                if (it == savepoints.end())
+                    return nullptr;
+                position = it - savepoints.begin();
+            }
+
+            auto data = archive_->data(name, position, sizeof(T) * dims[0] * dims[1] * dims[2]);
+            if (!data || reinterpret_cast< std::uintptr_t >(data.get()) % alignof(T) != 0)
+                return nullptr;
+
+            // The mapping is private, hence handing out mutable data does not modify the archive
+            return std::shared_ptr< T >(data, reinterpret_cast< T * >(const_cast< char * >(data.get())));
+        }
+
+        /// Mutex guarding all calls to @c serializer, shared by the serialization objects which exist at once
+        static std::shared_ptr< std::mutex > serializer_mutex(const ser::serializer *serializer) {
+            static std::mutex registryMutex;
+            static std::map< const ser::serializer *, std::weak_ptr< std::mutex > > registry;
+            std::lock_guard< std::mutex > lock(registryMutex);
+
+            std::shared_ptr< std::mutex > mutex = registry[serializer].lock();
+            if (!mutex) {
+                // Drop the mutexes which are no longer used
+                for (auto it = registry.begin(); it != registry.end();)
+                    it = it->second.expired() ? registry.erase(it) : std::next(it);
+                mutex = std::make_shared< std::mutex >();
+                registry[serializer] = mutex;
+            }
+            return mutex;
+        }
 
         bool can_transform_dimension(int serialized_size, int verifier_size) {
             // We allow automatic transformation of D-1-dim fields to D-dim fields if the length of the dimension is 1
@@ -0,0 +1,85 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <system_error>
+#include <unistd.h>
+
+namespace gt_verification {
+
+    thread_pool &thread_pool::get_instance() {
+        // The initialization of a local static is thread-safe, the instance is never destroyed
+        static thread_pool *instance = new thread_pool;
+        return (*instance);
+    }
+
+    thread_pool::thread_pool() : pid_(getpid()) {}
+
+    void thread_pool::run(int numBlocks, const std::function< void(int) > &task) {
+        // A forked child only has the calling thread
+        if (numBlocks <= 1 || getpid() != pid_) {
+            for (int block = 0; block < numBlocks; ++block)
+                task(block);
+            return;
+        }
+
+        batch b{&task, numBlocks, 0, 0};
+        std::unique_lock< std::mutex > lock(mutex_);
+        while ((int)workers_.size() < numBlocks - 1) {
+            try {
+                workers_.emplace_back(&thread_pool::run_worker, this);
+            } catch (std::system_error &) {
+                // The existing workers and the calling thread process the blocks
+                break;
+            }
+        }
+        batches_.push_back(&b);
+        for (int n = 1; n < numBlocks; ++n)
+            wakeup_.notify_one();
+
+        while (b.next < b.numBlocks) {
+            const int block = take(b);
+            lock.unlock();
+            task(block);
+            lock.lock();
+            ++b.done;
+        }
+        finished_.wait(lock, [&] { return b.done == b.numBlocks; });
+    }
+
+    int thread_pool::num_workers() const noexcept {
+        std::lock_guard< std::mutex > lock(mutex_);
+        return workers_.size();
+    }
+
+    int thread_pool::take(batch &b) {
+        const int block = b.next++;
+        if (b.next == b.numBlocks)
+            batches_.erase(std::find(batches_.begin(), batches_.end(), &b));
+        return block;
+    }
+
+    void thread_pool::run_worker() {
+        std::unique_lock< std::mutex > lock(mutex_);
+        while (true) {
+            wakeup_.wait(lock, [this] { return !batches_.empty(); });
+            batch &b = *batches_.front();
+            const int block = take(b);
+            lock.unlock();
+            (*b.task)(block);
+            lock.lock();
+
+            // The batch is released by its caller once all blocks are done, i.e. it must not be accessed afterwards
+            if (++b.done == b.numBlocks)
+                finished_.notify_all();
+        }
+    }
+} // namespace gt_verification
@@ -0,0 +1,83 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+namespace gt_verification {
+
+    /**
+     * @brief Process-wide pool of worker threads used by parallel_for_blocks()
+     *
+     * The workers are created on first use, as many as the largest request needs, and are reused by all
+     * following requests. They are never joined, the pool lives until the end of the process.
+     *
+     * The calling thread of run() processes blocks as well and only waits for blocks already taken by a worker.
+     * Hence, run() may be called from within a block (nested parallelism) without deadlocking, even if all
+     * workers are busy. In a forked child, which does not inherit the workers, all blocks are processed by the
+     * calling thread.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    class thread_pool : private boost::noncopyable /* singleton */
+    {
+        thread_pool();
+
+      public:
+        /**
+         * @brief Return the instance of the pool
+         */
+        static thread_pool &get_instance();
+
+        /**
+         * @brief Invoke `task(block)` for every block in [0, numBlocks) on the calling thread and up to
+         * `numBlocks - 1` workers and return once all blocks are processed
+         *
+         * The blocks are taken in ascending order. @c task must not throw.
+         */
+        void run(int numBlocks, const std::function< void(int) > &task);
+
+        /**
+         * @brief Number of worker threads created so far
+         */
+        int num_workers() const noexcept;
+
+      private:
+        /// Blocks of one call to run()
+        struct batch {
+            const std::function< void(int) > *task;
+            int numBlocks;
+            int next; ///< Next block to take
+            int done; ///< Number of processed blocks
+        };
+
+        /// Take the next block of @c b and remove @c b from the queue once all its blocks are taken (must be called
+        /// with the mutex locked)
+        int take(batch &b);
+
+        void run_worker();
+
+        const pid_t pid_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable wakeup_;
+        std::condition_variable finished_;
+        std::deque< batch * > batches_; ///< Batches with blocks which are not yet taken
+        std::vector< std::thread > workers_;
+    };
+} // namespace gt_verification
@@ -11,14 +11,26 @@
 #pragma once
 
 #include "../common.h"
+#include "loop_nest.h"
+#include <algorithm>
+#include <array>
 #include <boost/mpl/bool.hpp>
 #include <boost/type_traits.hpp>
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <utility>
 
 namespace gt_verification {
 
+    /**
+     * @brief Tag to construct a type_erased_field which only allocates storage without copying the data
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    struct allocate_only_t {};
+    constexpr allocate_only_t allocate_only{};
+
     namespace internal {
 
         /**
@@ -141,19 +153,27 @@ namespace gt_verification {
                 // Update field on host
                 field_.sync();
 
-                // Copy field
-                int iSize = this->i_size();
-                int jSize = this->j_size();
-                int kSize = this->k_size();
+                // Copy field, the innermost loop runs along the unit-stride dimension of the layout
                 auto src = make_host_view(field);
                 auto dst = make_host_view(field_);
-                for (int i = 0; i < iSize; ++i)
-                    for (int j = 0; j < jSize; ++j)
-                        for (int k = 0; k < kSize; ++k)
-                            dst(i, j, k) = src(i, j, k);
+                const loop_nest nest(this->i_stride(), this->j_stride(), this->k_stride());
+                for_each_row({{0, 0, 0}},
+                    {{this->i_size(), this->j_size(), this->k_size()}},
+                    nest,
+                    [&](const std::array< int, 3 > &start, int n) {
+                        std::array< int, 3 > pos = start;
+                        for (int idx = 0; idx < n; ++idx, ++pos[nest.inner()])
+                            dst(pos[0], pos[1], pos[2]) = src(pos[0], pos[1], pos[2]);
+                    });
                 field.sync();
             }
 
+            type_erased_field_base(const FieldType &field, allocate_only_t)
+                : metaData_(field.get_storage_info_ptr()->template total_length< 0 >(),
+                      field.get_storage_info_ptr()->template total_length< 1 >(),
+                      field.get_storage_info_ptr()->template total_length< 2 >()),
+                  field_(metaData_, field.name()) {}
+
             const T &access(int i, int j, int k) const noexcept override { return make_host_view(field_)(i, j, k); }
 
             T &access(int i, int j, int k) noexcept override { return make_host_view(field_)(i, j, k); }
@@ -183,6 +203,53 @@ namespace gt_verification {
             FieldType field_;
         };
 
+        /**
+         * Field over external memory with the given strides (the memory is kept alive by the field)
+         */
+        template < typename T >
+        class type_erased_field_memory_base : public type_erased_field_interface< T > {
+          public:
+            type_erased_field_memory_base(std::shared_ptr< T > data,
+                std::string name,
+                const std::array< int, 3 > &sizes,
+                const std::array< int, 3 > &strides)
+                : data_(data), name_(name), sizes_(sizes), strides_(strides) {}
+
+            const T &access(int i, int j, int k) const noexcept override {
+                return data_.get()[i * strides_[0] + j * strides_[1] + k * strides_[2]];
+            }
+
+            T &access(int i, int j, int k) noexcept override {
+                return data_.get()[i * strides_[0] + j * strides_[1] + k * strides_[2]];
+            }
+
+            T *data() noexcept override { return data_.get(); }
+
+            const T *data() const noexcept override { return data_.get(); }
+
+            const char *name() const noexcept override { return name_.c_str(); }
+
+            int i_size() const noexcept override { return sizes_[0]; }
+
+            int j_size() const noexcept override { return sizes_[1]; }
+
+            int k_size() const noexcept override { return sizes_[2]; }
+
+            int i_stride() const noexcept override { return strides_[0]; }
+
+            int j_stride() const noexcept override { return strides_[1]; }
+
+            int k_stride() const noexcept override { return strides_[2]; }
+
+            void sync() noexcept override {}
+
+          private:
+            std::shared_ptr< T > data_;
+            std::string name_;
+            std::array< int, 3 > sizes_;
+            std::array< int, 3 > strides_;
+        };
+
         class type_erased_field_view;
 
         template < typename T >
@@ -300,6 +367,26 @@ namespace gt_verification {
          */
         int k_stride() const noexcept { return base_->k_stride(); }
 
+        /**
+         * @brief Check if the field can be addressed as `data()[i * i_stride() + j * j_stride() + k * k_stride()]`
+         *
+         * This holds for all regular GridTools storages and allows to bypass the (virtual) element access
+         * of the view. The addresses of the last element in each direction are compared to the ones
+         * computed from the strides.
+         */
+        bool is_strided() const noexcept {
+            const T *origin = data();
+            if (!origin || size() == 0)
+                return false;
+
+            const int iLast = i_size() - 1, jLast = j_size() - 1, kLast = k_size() - 1;
+            return &(*this)(iLast, 0, 0) == origin + iLast * i_stride() &&
+                   &(*this)(0, jLast, 0) == origin + jLast * j_stride() &&
+                   &(*this)(0, 0, kLast) == origin + kLast * k_stride() &&
+                   &(*this)(iLast, jLast, kLast) ==
+                       origin + iLast * i_stride() + jLast * j_stride() + kLast * k_stride();
+        }
+
         /**
          * @brief Name of the field
          */
@@ -354,6 +441,32 @@ namespace gt_verification {
             base_ = std::make_shared< internal::type_erased_field_base< FieldType, T > >(field);
         }
 
+        /**
+         * @brief Create a TypeErasedField with the same sizes and layout as the GridTools field
+         *
+         * Only the storage is allocated (its content is undefined), the data of @c field is not copied.
+         * Construction cost is O(1) in data movement.
+         */
+        template < class FieldType >
+        type_erased_field(const FieldType &field, allocate_only_t) {
+            base_ = std::make_shared< internal::type_erased_field_base< FieldType, T > >(field, allocate_only);
+        }
+
+        /**
+         * @brief Create a TypeErasedField over external memory (host only, no data is copied)
+         *
+         * @param data      Pointer to the first element, the memory is kept alive as long as the field
+         * @param name      Name of the field
+         * @param sizes     Sizes in (i, j, k)-direction
+         * @param strides   Strides in (i, j, k)-direction
+         */
+        type_erased_field(std::shared_ptr< T > data,
+            const std::string &name,
+            const std::array< int, 3 > &sizes,
+            const std::array< int, 3 > &strides) {
+            base_ = std::make_shared< internal::type_erased_field_memory_base< T > >(data, name, sizes, strides);
+        }
+
         /**
          * @brief Access the field at position (i, j, k) and return a const refrence of the held value
          */
@@ -427,4 +540,43 @@ namespace gt_verification {
       private:
         std::shared_ptr< internal::type_erased_field_interface< T > > base_;
     };
+
+    /**
+     * @brief Copy the content of the field @c src into the field @c dst of the same sizes
+     *
+     * The innermost loop runs along the unit-stride dimension of @c dst. If both fields are strided with the
+     * same strides, each row is copied as a contiguous block.
+     *
+     * @ingroup DycoreUnittestCoreLibrary
+     */
+    template < typename T >
+    void copy_field(const type_erased_field_view< T > &src, type_erased_field_view< T > dst) noexcept {
+        src.sync();
+        dst.sync();
+
+        const std::array< int, 3 > strides{{dst.i_stride(), dst.j_stride(), dst.k_stride()}};
+        const std::array< int, 3 > sizes{{dst.i_size(), dst.j_size(), dst.k_size()}};
+        const loop_nest nest(strides[0], strides[1], strides[2]);
+
+        const bool sameStrides =
+            src.i_stride() == strides[0] && src.j_stride() == strides[1] && src.k_stride() == strides[2];
+
+        if (sameStrides && strides[nest.inner()] == 1 && src.is_strided() && dst.is_strided()) {
+            const T *srcData = src.data();
+            T *dstData = dst.data();
+            for_each_row({{0, 0, 0}}, sizes, nest, [&](const std::array< int, 3 > &start, int n) {
+                const int offset = start[0] * strides[0] + start[1] * strides[1] + start[2] * strides[2];
+                std::copy(srcData + offset, srcData + offset + n, dstData + offset);
+            });
+        } else {
+            for_each_row({{0, 0, 0}}, sizes, nest, [&](const std::array< int, 3 > &start, int n) {
+                std::array< int, 3 > pos = start;
+                for (int idx = 0; idx < n; ++idx, ++pos[nest.inner()])
+                    dst(pos[0], pos[1], pos[2]) = src(pos[0], pos[1], pos[2]);
+            });
+        }
+
+        dst.sync();
+        src.sync();
+    }
 } // namespace gt_verification
@@ -13,6 +13,7 @@
 #include <cmath>
 #include "../common.h"
 #include "error_metric_interface.h"
+#include "tolerance_kernel.h"
 
 namespace gt_verification {
 
@@ -27,6 +28,9 @@ namespace gt_verification {
      * |a - b| \leq (\texttt{atol} + \texttt{rtol} \cdot |b|)
      * @f]
      *
+     * The metric can be used through error_metric_interface or as a static policy (see
+     * verification::verify()) in which case the checks are inlined.
+     *
      * @ingroup DycoreUnittestVerificationLibrary
      */
     template < typename T >
@@ -48,10 +52,114 @@ namespace gt_verification {
          *
          * @return true iff absolute(a - b) <= (atol + rtol * absolute(b))
          */
-        bool equal(T a, T b) const noexcept override { return (std::fabs(a - b) <= (atol_ + rtol_ * std::fabs(b))); }
+        bool equal(T a, T b) const noexcept final { return (std::fabs(a - b) <= (atol_ + rtol_ * std::fabs(b))); }
+
+        /**
+         * @brief Vectorized version of equal() for @c n consecutive entries
+         *
+         * @return Number of entries which are @b not equal
+         */
+        int equal_n(const T *a, const T *b, int n, bool *mask) const noexcept final {
+            return internal::tolerance_check_n(a, b, n, rtol_, atol_, mask);
+        }
 
       private:
         T rtol_;
         T atol_;
     };
+
+    /**
+     * @brief Define a metric to compare real numbers within the given absolute tolerance
+     *
+     * @f[
+     * |a - b| \leq \texttt{atol}
+     * @f]
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    template < typename T >
+    class absolute_error_metric : public error_metric_interface< T > {
+      public:
+        absolute_error_metric(const absolute_error_metric &) = default;
+        absolute_error_metric &operator=(const absolute_error_metric &) = default;
+
+        /**
+         * @brief Initialize the metric with the absolute tolerance
+         */
+        explicit absolute_error_metric(T atol) : atol_(atol) {}
+
+        /**
+         * @brief Check if two real numbers @c a and @c b are equal within the absolute tolerance
+         *
+         * @return true iff absolute(a - b) <= atol
+         */
+        bool equal(T a, T b) const noexcept final { return (std::fabs(a - b) <= atol_); }
+
+        int equal_n(const T *a, const T *b, int n, bool *mask) const noexcept final {
+            return internal::tolerance_check_n(a, b, n, T(0), atol_, mask);
+        }
+
+      private:
+        T atol_;
+    };
+
+    /**
+     * @brief Define a metric to compare real numbers within the given relative tolerance
+     *
+     * @f[
+     * |a - b| \leq \texttt{rtol} \cdot |b|
+     * @f]
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    template < typename T >
+    class relative_error_metric : public error_metric_interface< T > {
+      public:
+        relative_error_metric(const relative_error_metric &) = default;
+        relative_error_metric &operator=(const relative_error_metric &) = default;
+
+        /**
+         * @brief Initialize the metric with the relative tolerance
+         */
+        explicit relative_error_metric(T rtol) : rtol_(rtol) {}
+
+        /**
+         * @brief Check if two real numbers @c a and @c b are equal within the relative tolerance
+         *
+         * @return true iff absolute(a - b) <= rtol * absolute(b)
+         */
+        bool equal(T a, T b) const noexcept final { return (std::fabs(a - b) <= rtol_ * std::fabs(b)); }
+
+        int equal_n(const T *a, const T *b, int n, bool *mask) const noexcept final {
+            return internal::tolerance_check_n(a, b, n, rtol_, T(0), mask);
+        }
+
+      private:
+        T rtol_;
+    };
+
+    /**
+     * @brief Define a metric which only accepts exactly equal numbers
+     *
+     * Note that NaNs are never equal while 0 and -0 are.
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    template < typename T >
+    class exact_error_metric : public error_metric_interface< T > {
+      public:
+        /**
+         * @brief Check if two numbers @c a and @c b are exactly equal
+         */
+        bool equal(T a, T b) const noexcept final { return a == b; }
+
+        int equal_n(const T *a, const T *b, int n, bool *mask) const noexcept final {
+            int mismatches = 0;
+            for (int i = 0; i < n; ++i) {
+                mask[i] = (a[i] == b[i]);
+                mismatches += !mask[i];
+            }
+            return mismatches;
+        }
+    };
 }
@@ -22,5 +22,22 @@ namespace gt_verification {
          * @brief Check if two real numbers @c a and @c b are equal within a tolerance
          */
         virtual bool equal(T a, T b) const noexcept = 0;
+
+        /**
+         * @brief Check @c n consecutive entries of @c a and @c b for equality
+         *
+         * The result of each comparison is stored in @c mask. The default implementation calls equal() for
+         * each entry.
+         *
+         * @return Number of entries which are @b not equal
+         */
+        virtual int equal_n(const T *a, const T *b, int n, bool *mask) const noexcept {
+            int mismatches = 0;
+            for (int i = 0; i < n; ++i) {
+                mask[i] = equal(a[i], b[i]);
+                mismatches += !mask[i];
+            }
+            return mismatches;
+        }
     };
 }
@@ -0,0 +1,280 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <vector>
+#include "../common.h"
+
+namespace gt_verification {
+
+    /**
+     * @brief Histogram of positive errors with one bin per decade
+     *
+     * Bin @c b counts the errors in [10^(min_exponent + b), 10^(min_exponent + b + 1)). The first bin also
+     * counts all smaller errors and the last bin all larger ones (including infinity), NaNs are ignored.
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    class error_histogram {
+      public:
+        static constexpr int min_exponent = -18;
+        static constexpr int num_bins = 30;
+
+        error_histogram() : counts_{} {}
+
+        /**
+         * @brief Count a positive error
+         */
+        void add(double error) noexcept {
+            if (!(error > 0))
+                return;
+            const double exponent = std::floor(std::log10(error)) - min_exponent;
+            const int bin = exponent < 0 ? 0 : (exponent >= num_bins ? num_bins - 1 : static_cast< int >(exponent));
+            ++counts_[bin];
+        }
+
+        /**
+         * @brief Merge the counts of @c other into this
+         */
+        void merge(const error_histogram &other) noexcept {
+            for (int bin = 0; bin < num_bins; ++bin)
+                counts_[bin] += other.counts_[bin];
+        }
+
+        /**
+         * @brief Number of errors in bin @c bin
+         */
+        std::size_t count(int bin) const noexcept { return counts_[bin]; }
+
+        /**
+         * @brief Lower bound 10^(min_exponent + bin) of bin @c bin
+         */
+        static double lower_bound(int bin) noexcept { return std::pow(10.0, min_exponent + bin); }
+
+        /**
+         * @brief Number of counted errors
+         */
+        std::size_t total() const noexcept {
+            std::size_t total = 0;
+            for (int bin = 0; bin < num_bins; ++bin)
+                total += counts_[bin];
+            return total;
+        }
+
+      private:
+        std::array< std::size_t, num_bins > counts_;
+    };
+
+    /**
+     * @brief Statistics of the difference between an output field and a reference field
+     *
+     * The statistics are accumulated row by row during verification::verify(). The sum of the squared
+     * errors of each row is added with Kahan (compensated) summation and all accumulations are carried out
+     * in double precision. The relative error of an entry is |a - b| / |b|, if b is zero it is 0 for a == b
+     * and infinity otherwise. NaNs do not contribute to the maxima but propagate into the norms.
+     *
+     * The absolute and relative errors of all differing entries are counted in @ref error_histogram
+     * "histograms" and the mismatches reported by the error metric are counted per k-layer.
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    class error_statistics {
+      public:
+        error_statistics()
+            : numPoints_(0), sumSquares_(0), compensation_(0), maxAbsError_(0), maxRelError_(0), worstI_(-1),
+              worstJ_(-1), worstK_(-1) {}
+
+        /**
+         * @brief Accumulate @c n entries of a row starting at position @c start along dimension @c dim
+         *
+         * @param out       Output values of the row, `out[idx]` is the entry at `start + idx` along @c dim
+         * @param ref       Reference values of the row, `ref[idx]` is the entry at `start + idx` along @c dim
+         * @param n         Length of the row
+         * @param start     Position (i, j, k) of the first entry
+         * @param dim       Dimension of the row (0 = i, 1 = j, 2 = k)
+         */
+        template < typename OutRow, typename RefRow >
+        void add_row(
+            const OutRow &out, const RefRow &ref, int n, const std::array< int, 3 > &start, int dim) noexcept {
+            double rowSumSquares = 0;
+            double rowMaxAbsError = 0;
+            int rowWorst = -1;
+
+            for (int idx = 0; idx < n; ++idx) {
+                const double a = out[idx];
+                const double b = ref[idx];
+                const double absError = std::fabs(a - b);
+
+                rowSumSquares += absError * absError;
+
+                if (absError > rowMaxAbsError) {
+                    rowMaxAbsError = absError;
+                    rowWorst = idx;
+                }
+
+                if (absError > 0) {
+                    const double relError =
+                        (b != 0) ? absError / std::fabs(b) : std::numeric_limits< double >::infinity();
+                    if (relError > maxRelError_)
+                        maxRelError_ = relError;
+
+                    absHistogram_.add(absError);
+                    relHistogram_.add(relError);
+                }
+            }
+
+            if (rowWorst >= 0) {
+                std::array< int, 3 > worst = start;
+                worst[dim] += rowWorst;
+                update_worst(rowMaxAbsError, worst[0], worst[1], worst[2]);
+            }
+
+            add_compensated(rowSumSquares);
+            numPoints_ += n;
+        }
+
+        /**
+         * @brief Account for @c n entries which are identical to the reference
+         */
+        void add_identical(std::size_t n) noexcept { numPoints_ += n; }
+
+        /**
+         * @brief Account for @c n entries of the k-layer @c k which do not match the reference
+         */
+        void add_mismatches(int k, std::size_t n) {
+            if (k >= (int)mismatchesPerK_.size())
+                mismatchesPerK_.resize(k + 1, 0);
+            mismatchesPerK_[k] += n;
+        }
+
+        /**
+         * @brief Merge the statistics of @c other into this
+         */
+        void merge(const error_statistics &other) noexcept {
+            numPoints_ += other.numPoints_;
+            add_compensated(other.sumSquares_);
+            add_compensated(-other.compensation_);
+
+            if (other.has_worst_point())
+                update_worst(other.maxAbsError_, other.worstI_, other.worstJ_, other.worstK_);
+            if (other.maxRelError_ > maxRelError_)
+                maxRelError_ = other.maxRelError_;
+
+            absHistogram_.merge(other.absHistogram_);
+            relHistogram_.merge(other.relHistogram_);
+            if (other.mismatchesPerK_.size() > mismatchesPerK_.size())
+                mismatchesPerK_.resize(other.mismatchesPerK_.size(), 0);
+            for (std::size_t k = 0; k < other.mismatchesPerK_.size(); ++k)
+                mismatchesPerK_[k] += other.mismatchesPerK_[k];
+        }
+
+        /**
+         * @brief Number of compared entries
+         */
+        std::size_t num_points() const noexcept { return numPoints_; }
+
+        /**
+         * @brief Maximum absolute error max(|a - b|)
+         */
+        double max_absolute_error() const noexcept { return maxAbsError_; }
+
+        /**
+         * @brief Maximum relative error max(|a - b| / |b|)
+         */
+        double max_relative_error() const noexcept { return maxRelError_; }
+
+        /**
+         * @brief Root mean square of the error sqrt(sum((a - b)^2) / n)
+         */
+        double rms_error() const noexcept { return numPoints_ ? std::sqrt(sumSquares_ / numPoints_) : 0.0; }
+
+        /**
+         * @brief L2 norm of the difference sqrt(sum((a - b)^2))
+         */
+        double l2_norm() const noexcept { return std::sqrt(sumSquares_); }
+
+        /**
+         * @brief Linf norm of the difference max(|a - b|)
+         */
+        double linf_norm() const noexcept { return maxAbsError_; }
+
+        /**
+         * @brief Check if a worst point exists (i.e. if any entry differs from the reference)
+         */
+        bool has_worst_point() const noexcept { return worstI_ >= 0; }
+
+        /**
+         * @brief Position of the entry with the largest absolute error (-1 if all entries are equal)
+         * @{
+         */
+        int worst_i() const noexcept { return worstI_; }
+        int worst_j() const noexcept { return worstJ_; }
+        int worst_k() const noexcept { return worstK_; }
+        /** @} */
+
+        /**
+         * @brief Histogram of the absolute errors |a - b| of the differing entries
+         */
+        const error_histogram &absolute_error_histogram() const noexcept { return absHistogram_; }
+
+        /**
+         * @brief Histogram of the relative errors |a - b| / |b| of the differing entries
+         */
+        const error_histogram &relative_error_histogram() const noexcept { return relHistogram_; }
+
+        /**
+         * @brief Number of mismatches in the k-layer @c k
+         */
+        std::size_t num_mismatches(int k) const noexcept {
+            return k >= 0 && k < (int)mismatchesPerK_.size() ? mismatchesPerK_[k] : 0;
+        }
+
+        /**
+         * @brief Number of mismatches per k-layer (layers above the last mismatching one are omitted)
+         */
+        const std::vector< std::size_t > &mismatches_per_k() const noexcept { return mismatchesPerK_; }
+
+      private:
+        void update_worst(double absError, int i, int j, int k) noexcept {
+            // Ties are resolved in favour of the first position in (k, j, i) order, which makes the worst point
+            // independent of the order in which the rows are accumulated
+            if (absError > maxAbsError_ || (absError == maxAbsError_ && has_worst_point() &&
+                                                std::tie(k, j, i) < std::tie(worstK_, worstJ_, worstI_))) {
+                maxAbsError_ = absError;
+                worstI_ = i;
+                worstJ_ = j;
+                worstK_ = k;
+            }
+        }
+
+        void add_compensated(double value) noexcept {
+            const double y = value - compensation_;
+            const double t = sumSquares_ + y;
+            compensation_ = (t - sumSquares_) - y;
+            sumSquares_ = t;
+        }
+
+        std::size_t numPoints_;
+        double sumSquares_;
+        double compensation_;
+        double maxAbsError_;
+        double maxRelError_;
+        int worstI_, worstJ_, worstK_;
+        error_histogram absHistogram_;
+        error_histogram relHistogram_;
+        std::vector< std::size_t > mismatchesPerK_;
+    };
+} // namespace gt_verification
@@ -0,0 +1,126 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace gt_verification {
+
+    /**
+     * @brief Connected region of failures (see find_failure_regions())
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    struct failure_region {
+        int iMin, iMax, jMin, jMax, kMin, kMax; ///< Bounding box (inclusive)
+        std::size_t numPoints;                  ///< Number of failures in the region
+        double maxAbsError;                     ///< Maximum absolute error |out - ref| in the region
+        int worstI, worstJ, worstK;             ///< Position of the maximum absolute error
+    };
+
+    /**
+     * @brief Group failures into regions of face-connected positions
+     *
+     * Two failures are connected if their positions differ by one in exactly one dimension. The regions are
+     * found by a union-find pass over the failures whose positions are looked up in a hash map, i.e. in
+     * expected linear time in the number of failures.
+     *
+     * @param failures  Failures with members i, j, k, outVal and refVal (e.g. verification::failures())
+     * @return The regions ordered by decreasing number of points (ties in the order of their first failure)
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    template < typename Failure >
+    std::vector< failure_region > find_failure_regions(const std::vector< Failure > &failures) {
+        const std::size_t n = failures.size();
+
+        // Positions are packed into 64 bit keys (21 bits per dimension)
+        auto key = [](int i, int j, int k) {
+            return (std::uint64_t(std::uint32_t(i) & 0x1fffff) << 42) |
+                   (std::uint64_t(std::uint32_t(j) & 0x1fffff) << 21) | std::uint64_t(std::uint32_t(k) & 0x1fffff);
+        };
+
+        std::unordered_map< std::uint64_t, std::size_t > index;
+        index.reserve(n);
+        for (std::size_t idx = 0; idx < n; ++idx)
+            index.emplace(key(failures[idx].i, failures[idx].j, failures[idx].k), idx);
+
+        // Union-find with path halving and union by size
+        std::vector< std::size_t > parent(n), size(n, 1);
+        std::iota(parent.begin(), parent.end(), std::size_t(0));
+        auto find = [&](std::size_t x) {
+            while (parent[x] != x)
+                x = parent[x] = parent[parent[x]];
+            return x;
+        };
+        auto unite = [&](std::size_t a, std::size_t b) {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return;
+            if (size[a] < size[b])
+                std::swap(a, b);
+            parent[b] = a;
+            size[a] += size[b];
+        };
+
+        // Connecting each failure with its predecessors in every dimension covers all face neighbours
+        for (std::size_t idx = 0; idx < n; ++idx) {
+            const auto &f = failures[idx];
+            for (auto neighbour : {key(f.i - 1, f.j, f.k), key(f.i, f.j - 1, f.k), key(f.i, f.j, f.k - 1)}) {
+                auto it = index.find(neighbour);
+                if (it != index.end())
+                    unite(idx, it->second);
+            }
+        }
+
+        // Accumulate the regions
+        std::vector< failure_region > regions;
+        std::vector< std::size_t > regionOfRoot(n, n);
+        for (std::size_t idx = 0; idx < n; ++idx) {
+            const auto &f = failures[idx];
+            const double absError = std::fabs(double(f.outVal) - double(f.refVal));
+            const std::size_t root = find(idx);
+
+            if (regionOfRoot[root] == n) {
+                regionOfRoot[root] = regions.size();
+                regions.push_back(failure_region{f.i, f.i, f.j, f.j, f.k, f.k, 0, absError, f.i, f.j, f.k});
+            }
+
+            failure_region &region = regions[regionOfRoot[root]];
+            region.iMin = std::min(region.iMin, f.i);
+            region.iMax = std::max(region.iMax, f.i);
+            region.jMin = std::min(region.jMin, f.j);
+            region.jMax = std::max(region.jMax, f.j);
+            region.kMin = std::min(region.kMin, f.k);
+            region.kMax = std::max(region.kMax, f.k);
+            ++region.numPoints;
+            if (absError > region.maxAbsError) {
+                region.maxAbsError = absError;
+                region.worstI = f.i;
+                region.worstJ = f.j;
+                region.worstK = f.k;
+            }
+        }
+
+        std::stable_sort(regions.begin(), regions.end(), [](const failure_region &a, const failure_region &b) {
+            return a.numPoints > b.numPoints;
+        });
+        return regions;
+    }
+} // namespace gt_verification
@@ -0,0 +1,268 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "failure_report.h"
+#include "../verification_exception.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace gt_verification {
+
+    namespace {
+        /// Character following the backslash if @c c has a short JSON escape sequence, otherwise 0
+        char json_escape(char c) noexcept {
+            switch (c) {
+            case '"':
+            case '\\':
+                return c;
+            case '\b':
+                return 'b';
+            case '\f':
+                return 'f';
+            case '\n':
+                return 'n';
+            case '\r':
+                return 'r';
+            case '\t':
+                return 't';
+            default:
+                return 0;
+            }
+        }
+    } // namespace
+
+    failure_report::failure_report(const std::string &path, report_format format, std::size_t bufferSize)
+        : file_(std::fopen(path.c_str(), "wb")), format_(format), buffer_(std::max< std::size_t >(bufferSize, 256)),
+          used_(0) {
+        if (!file_)
+            throw verification_exception("cannot open the failure report '%s'", path);
+
+        if (format_ == report_format::csv)
+            append("type,collection,field,i,j,k,output,reference,points,failures,stored,max_abs_error,"
+                   "max_rel_error,rms_error,l2_norm,linf_norm\n");
+        else if (format_ == report_format::binary)
+            append("GTVREP01", 8);
+    }
+
+    failure_report::~failure_report() {
+        flush_buffer();
+        std::fclose(file_);
+    }
+
+    report_format failure_report::parse_format(const std::string &name) {
+        if (name == "jsonl")
+            return report_format::jsonl;
+        if (name == "csv")
+            return report_format::csv;
+        if (name == "bin")
+            return report_format::binary;
+        throw verification_exception("unknown report format '%s' (expected 'jsonl', 'csv' or 'bin')", name);
+    }
+
+    void failure_report::flush() {
+        std::lock_guard< std::mutex > lock(mutex_);
+        flush_buffer();
+    }
+
+    void failure_report::write_field(const std::string &collection,
+        const std::string &field,
+        const error_statistics &stats,
+        std::size_t numFailures,
+        std::size_t numStored) {
+        const double values[] = {stats.max_absolute_error(),
+            stats.max_relative_error(),
+            stats.rms_error(),
+            stats.l2_norm(),
+            stats.linf_norm()};
+        const char *names[] = {"max_abs_error", "max_rel_error", "rms_error", "l2_norm", "linf_norm"};
+
+        switch (format_) {
+        case report_format::jsonl:
+            append("{\"type\":\"field\",\"collection\":");
+            append_string(collection);
+            append(",\"field\":");
+            append_string(field);
+            append(",\"points\":");
+            append_number(std::uint64_t(stats.num_points()));
+            append(",\"failures\":");
+            append_number(std::uint64_t(numFailures));
+            append(",\"stored\":");
+            append_number(std::uint64_t(numStored));
+            for (int n = 0; n < 5; ++n) {
+                append(",\"");
+                append(names[n]);
+                append("\":");
+                append_number(values[n]);
+            }
+            append("}\n");
+            break;
+        case report_format::csv:
+            append("field,");
+            append_string(collection);
+            append(",");
+            append_string(field);
+            append(",,,,,,");
+            append_number(std::uint64_t(stats.num_points()));
+            append(",");
+            append_number(std::uint64_t(numFailures));
+            append(",");
+            append_number(std::uint64_t(numStored));
+            for (int n = 0; n < 5; ++n) {
+                append(",");
+                append_number(values[n]);
+            }
+            append("\n");
+            break;
+        case report_format::binary:
+            append_binary(std::uint8_t('F'));
+            append_string(collection);
+            append_string(field);
+            append_binary(std::uint64_t(stats.num_points()));
+            append_binary(std::uint64_t(numFailures));
+            append_binary(std::uint64_t(numStored));
+            for (int n = 0; n < 5; ++n)
+                append_binary(values[n]);
+            break;
+        }
+    }
+
+    void failure_report::write_failure(const std::string &collection,
+        const std::string &field,
+        int i,
+        int j,
+        int k,
+        double outVal,
+        double refVal) {
+        switch (format_) {
+        case report_format::jsonl:
+            append("{\"type\":\"failure\",\"collection\":");
+            append_string(collection);
+            append(",\"field\":");
+            append_string(field);
+            append(",\"i\":");
+            append_number(std::uint64_t(i));
+            append(",\"j\":");
+            append_number(std::uint64_t(j));
+            append(",\"k\":");
+            append_number(std::uint64_t(k));
+            append(",\"output\":");
+            append_number(outVal);
+            append(",\"reference\":");
+            append_number(refVal);
+            append("}\n");
+            break;
+        case report_format::csv:
+            append("failure,");
+            append_string(collection);
+            append(",");
+            append_string(field);
+            append(",");
+            append_number(std::uint64_t(i));
+            append(",");
+            append_number(std::uint64_t(j));
+            append(",");
+            append_number(std::uint64_t(k));
+            append(",");
+            append_number(outVal);
+            append(",");
+            append_number(refVal);
+            append(",,,,,,,,\n");
+            break;
+        case report_format::binary:
+            append_binary(std::int32_t(i));
+            append_binary(std::int32_t(j));
+            append_binary(std::int32_t(k));
+            append_binary(outVal);
+            append_binary(refVal);
+            break;
+        }
+    }
+
+    void failure_report::append(const char *data, std::size_t size) {
+        if (used_ + size > buffer_.size()) {
+            flush_buffer();
+            if (size > buffer_.size()) {
+                std::fwrite(data, 1, size, file_);
+                return;
+            }
+        }
+        std::memcpy(buffer_.data() + used_, data, size);
+        used_ += size;
+    }
+
+    void failure_report::append_string(const std::string &str) {
+        switch (format_) {
+        case report_format::jsonl:
+            append("\"", 1);
+            for (char c : str) {
+                if (const char escape = json_escape(c)) {
+                    const char escaped[] = {'\\', escape};
+                    append(escaped, 2);
+                } else if (static_cast< unsigned char >(c) < 0x20) {
+                    char code[7];
+                    std::snprintf(code, sizeof(code), "\\u%04x", static_cast< unsigned >(c));
+                    append(code, 6);
+                } else
+                    append(&c, 1);
+            }
+            append("\"", 1);
+            break;
+        case report_format::csv:
+            if (str.find_first_of(",\"\n") == std::string::npos)
+                append(str);
+            else {
+                append("\"", 1);
+                for (char c : str) {
+                    append(&c, 1);
+                    if (c == '"')
+                        append(&c, 1);
+                }
+                append("\"", 1);
+            }
+            break;
+        case report_format::binary:
+            append_binary(std::uint32_t(str.size()));
+            append(str);
+            break;
+        }
+    }
+
+    void failure_report::append_number(double value) {
+        if (!std::isfinite(value)) {
+            if (format_ == report_format::jsonl)
+                append("null", 4);
+            else
+                append(std::isnan(value) ? "nan" : (value > 0 ? "inf" : "-inf"));
+            return;
+        }
+        char str[32];
+        const int size = std::snprintf(str, sizeof(str), "%.17g", value);
+        append(str, size);
+    }
+
+    void failure_report::append_number(std::uint64_t value) {
+        // Format the digits from the back
+        char str[24];
+        char *first = str + sizeof(str);
+        do {
+            *--first = char('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        append(first, str + sizeof(str) - first);
+    }
+
+    void failure_report::flush_buffer() {
+        if (used_ > 0)
+            std::fwrite(buffer_.data(), 1, used_, file_);
+        used_ = 0;
+        std::fflush(file_);
+    }
+} // namespace gt_verification
@@ -0,0 +1,134 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "../common.h"
+#include "error_statistics.h"
+#include "verification.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gt_verification {
+
+    /**
+     * @brief Format of a failure_report
+     */
+    enum class report_format { jsonl, csv, binary };
+
+    /**
+     * @brief Machine-readable report of failed verifications written to a file
+     *
+     * For every reported verification, a field record (statistics of the error) followed by one record per
+     * stored failure is written. The records are formatted into a large buffer which is written in blocks
+     * (the buffer is flushed after each verification).
+     *
+     * - `jsonl`: one JSON object per line, either
+     *   `{"type":"field","collection":..,"field":..,"points":..,"failures":..,"stored":..,"max_abs_error":..,
+     *   "max_rel_error":..,"rms_error":..,"l2_norm":..,"linf_norm":..}` or
+     *   `{"type":"failure","collection":..,"field":..,"i":..,"j":..,"k":..,"output":..,"reference":..}`.
+     *   Non-finite values are written as `null`.
+     * - `csv`: a header followed by one row per record with the columns `type,collection,field,i,j,k,output,
+     *   reference,points,failures,stored,max_abs_error,max_rel_error,rms_error,l2_norm,linf_norm` (columns
+     *   which do not apply to a record are empty).
+     * - `binary`: the magic `GTVREP01` followed by the field records in native byte order: the tag `'F'`
+     *   (uint8), collection and field name (each as uint32 length and characters), points, failures and stored
+     *   (uint64), the five statistics of the json format (double) and `stored` failures of i, j, k (int32),
+     *   output and reference (double).
+     *
+     * @ingroup DycoreUnittestVerificationLibrary
+     */
+    class failure_report : private boost::noncopyable {
+      public:
+        /**
+         * @brief Open (and truncate) the report @c path
+         *
+         * @throw verification_exception    The file cannot be opened
+         */
+        failure_report(const std::string &path, report_format format, std::size_t bufferSize = std::size_t(1) << 20);
+
+        /**
+         * @brief Flush and close the report
+         */
+        ~failure_report();
+
+        /**
+         * @brief Parse the name of a format (`jsonl`, `csv` or `bin`)
+         *
+         * @throw verification_exception    Unknown format
+         */
+        static report_format parse_format(const std::string &name);
+
+        /**
+         * @brief Write the statistics and the stored failures of a verification
+         *
+         * @param collection    Name of the collection the verification belongs to
+         * @param verif         Verification to report
+         */
+        template < typename T >
+        void write(const std::string &collection, const verification< T > &verif) {
+            std::lock_guard< std::mutex > lock(mutex_);
+
+            const std::string field = verif.output_field().name();
+            const auto &failures = verif.failures();
+            write_field(collection, field, verif.statistics(), verif.num_failures(), failures.size());
+            for (const auto &fail : failures)
+                write_failure(collection, field, fail.i, fail.j, fail.k, fail.outVal, fail.refVal);
+            flush_buffer();
+        }
+
+        /**
+         * @brief Write the buffered records to the file
+         */
+        void flush();
+
+        /**
+         * @brief Format of the report
+         */
+        report_format format() const noexcept { return format_; }
+
+      private:
+        void write_field(const std::string &collection,
+            const std::string &field,
+            const error_statistics &stats,
+            std::size_t numFailures,
+            std::size_t numStored);
+        void write_failure(const std::string &collection,
+            const std::string &field,
+            int i,
+            int j,
+            int k,
+            double outVal,
+            double refVal);
+
+        void append(const char *data, std::size_t size);
+        void append(const char *str) { append(str, std::strlen(str)); }
+        void append(const std::string &str) { append(str.data(), str.size()); }
+        void append_string(const std::string &str);
+        void append_number(double value);
+        void append_number(std::uint64_t value);
+        template < typename Pod >
+        void append_binary(const Pod &value) {
+            append(reinterpret_cast< const char * >(&value), sizeof(Pod));
+        }
+        void flush_buffer();
+
+        std::FILE *file_;
+        report_format format_;
+        std::vector< char > buffer_;
+        std::size_t used_;
+        std::mutex mutex_;
+    };
+} // namespace gt_verification
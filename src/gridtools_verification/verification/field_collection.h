@@ -12,16 +12,23 @@
 
 #include "../common.h"
 #include "../core/error.h"
+#include "../core/error_writer.h"
 #include "../core/logger.h"
+#include "../core/parallel.h"
+#include "../core/phase_timer.h"
+#include "../core/savepoint_index.h"
 #include "../core/serialization.h"
 #include "../core/type_erased_field.h"
 #include "../verification_exception.h"
 #include "boundary_extent.h"
 #include "error_metric_interface.h"
+#include "failure_report.h"
 #include "verification.h"
 #include "verification_reporter.h"
 #include "verification_result.h"
 #include "verification_specification.h"
+#include <atomic>
+#include <future>
 #include <vector>
 
 namespace gt_verification {
@@ -30,11 +37,15 @@ namespace gt_verification {
 
         struct savepoint_pair {
             template < class SavePointType >
-            savepoint_pair(SavePointType &&_input, SavePointType &&_output)
-                : input(std::forward< SavePointType >(_input)), output(std::forward< SavePointType >(_output)) {}
+            savepoint_pair(
+                SavePointType &&_input, SavePointType &&_output, int _inputPosition = -1, int _outputPosition = -1)
+                : input(std::forward< SavePointType >(_input)), output(std::forward< SavePointType >(_output)),
+                  inputPosition(_inputPosition), outputPosition(_outputPosition) {}
 
             ser::savepoint input;
             ser::savepoint output;
+            int inputPosition;  ///< Position of the input savepoint in the serializer (-1 if unknown)
+            int outputPosition; ///< Position of the output savepoint in the serializer (-1 if unknown)
         };
 
         template < typename T >
@@ -61,8 +72,18 @@ namespace gt_verification {
     template < typename T >
     class field_collection {
       public:
-        field_collection(verification_specification verificationSpecification)
-            : verificationSpecification_(verificationSpecification){};
+        /**
+         * @brief Create an empty collection
+         *
+         * @param name  Name of the collection under which report_failures() writes to the failure report
+         */
+        field_collection(verification_specification verificationSpecification, std::string name = "")
+            : name_(name), verificationSpecification_(verificationSpecification){};
+
+        /**
+         * @brief Get the name of the collection
+         */
+        const std::string &name() const noexcept { return name_; }
 
         /**
          * @brief Attach a reference serializer to the collection.
@@ -76,40 +97,58 @@ namespace gt_verification {
          * @param serializer        The serializer that loads the reference data
          * @param outSavepointName  The name of the savepoint where the reference values are stored
          * @param inSavepointName   The name of the savepoint where the input values are stored
+         * @param index             The index of the savepoints of @c serializer (built if not given)
+         * @param archive           The mapped Binary archive of @c serializer (opened if not given)
          */
         void attach_reference_serializer(std::shared_ptr< ser::serializer > serializer,
             const std::string &inSavepointName,
-            const std::string &outSavepointName) {
+            const std::string &outSavepointName,
+            std::shared_ptr< savepoint_index > index = nullptr,
+            std::shared_ptr< mapped_binary_archive > archive = nullptr) {
+            discard_prefetch();
             referenceSerializer_ = serializer;
 
-            const std::vector< ser::savepoint > &savepoints = referenceSerializer_->savepoints();
-            iterations_.clear();
+            if (!archive)
+                archive = mapped_binary_archive::open(serializer->directory(), serializer->prefix());
+            referenceArchive_ = archive;
 
-            for (auto it = savepoints.cbegin(), end = savepoints.cend(); it != end; ++it) {
-                if (it->name() == outSavepointName) {
-                    // Output savepoint is found, now search input savepoint
-                    auto rit = std::reverse_iterator< decltype(it) >(it);
-                    while (rit != savepoints.rend()) {
-                        if (rit->name() == inSavepointName)
-                            // Pair found, finish search
-                            break;
-                        ++rit;
-                    }
+            if (!index)
+                index = std::make_shared< savepoint_index >(*serializer);
 
-                    if (rit != savepoints.rend())
-                        iterations_.push_back(internal::savepoint_pair(*rit, *it));
-                }
-            }
+            iterations_.clear();
+            loadedIteration_ = -1;
+            for (const auto &pair : index->pairs(inSavepointName, outSavepointName))
+                iterations_.push_back(internal::savepoint_pair(
+                    index->savepoint(pair.first), index->savepoint(pair.second), pair.first, pair.second));
         }
 
         /**
          * @brief Attach an error serializer to the collection which will be used to serialize the
-         * error result to disk [not implemented]
+         * error result to disk
+         *
+         * The output field, the reference field and their difference of every failing field are written at
+         * the reference savepoint of the loaded iteration (up to verification_specification::dump_limit() bytes).
          *
          * @param serializer  The serializer which will be used to serialization
          *                    (in SerializerOpenModeWrite)
          */
-        void attach_error_serializer(std::shared_ptr< ser::serializer > serializer) { errorSerializer_ = serializer; }
+        void attach_error_serializer(std::shared_ptr< ser::serializer > serializer) {
+            errorWriter_ = std::make_shared< error_writer >(serializer, verificationSpecification_.dump_limit());
+        }
+
+        /**
+         * @brief Attach an error writer which serializes the error result to disk in the background
+         *
+         * The writer can be shared by several collections (see unittest_environment).
+         */
+        void attach_error_writer(std::shared_ptr< error_writer > writer) { errorWriter_ = writer; }
+
+        /**
+         * @brief Attach a machine-readable report to which report_failures() writes the failing fields
+         *
+         * The report can be shared by several collections (see unittest_environment).
+         */
+        void attach_failure_report(std::shared_ptr< failure_report > report) { failureReport_ = report; }
 
         /**
          * @brief Register an input field which will be filled during the loadIteration() function
@@ -122,6 +161,10 @@ namespace gt_verification {
         	field.sync();
             inputFields_.push_back(
                 internal::input_field< T >{fieldname, type_erased_field_view< T >(field), also_previous});
+
+            discard_prefetch();
+            if (verificationSpecification_.prefetch())
+                prefetchInputFields_.push_back(type_erased_field< T >(field, allocate_only));
         }
 
         /**
@@ -141,43 +184,111 @@ namespace gt_verification {
             boundaries_.push_back(boundary);
             outputFields_.push_back(std::make_pair(fieldname, type_erased_field_view< T >(field)));
 
-            // Construct new field holding the reference data
-            referenceFields_.push_back(std::make_pair(fieldname, type_erased_field< T >(field)));
+            // Allocate a new field holding the reference data (its content is loaded by load_iteration())
+            referenceStorage_.push_back(type_erased_field< T >(field, allocate_only));
+            referenceFields_.push_back(std::make_pair(fieldname, referenceStorage_.back()));
+
+            discard_prefetch();
+            if (verificationSpecification_.prefetch())
+                prefetchReferenceFields_.push_back(type_erased_field< T >(field, allocate_only));
         }
 
         /**
          * @brief Loads input values and reference values from disk into the input- and reference fields
          *
+         * The fields are loaded by verification_specification::num_threads() threads. All fields are
+         * attempted to be loaded and the failures of all of them are reported before exiting the program.
+         *
+         * If prefetching is enabled (see verification_specification::prefetch()), the next iteration is
+         * loaded into shadow buffers on a background thread afterwards. If the next call requests this
+         * iteration, the shadow buffers are swapped with the reference fields and copied into the input fields
+         * instead of reading from disk.
+         *
+         * Otherwise, reference fields with the layout of a Binary archive are mapped from the archive without
+         * copying them (see serialization::map()). If streaming is enabled (see
+         * verification_specification::stream_slab()), all reference fields of a Binary archive are mapped,
+         * regardless of their layout, and verify() releases them slab by slab.
+         *
          * After this the computations and verification can take place.
+         *
+         * The call is measured as the phase `load_iteration` (see phase_statistics) with the bytes of the loaded
+         * (but not the mapped) fields. The time until the next call of verify() is measured as the phase
+         * `stencil`.
          */
         void load_iteration(int iteration) {
             if (iteration >= (int)iterations_.size())
                 error::fatal(boost::format("invalid access of iteration '%i' (there are only %i iterations)") %
                              iteration % iterations_.size());
 
-            serialization serialization(referenceSerializer_);
+            stencilTimer_.reset();
+            phase_timer timer("load_iteration");
+            for (const auto &inputField : inputFields_)
+                timer.add_bytes(field_bytes(inputField.field_view()));
+
+            std::vector< std::string > errors;
+            if (prefetch_.valid() && prefetchIteration_ == iteration) {
+                VERIFICATION_LOG_INFO() << "Using prefetched iteration '" << iteration << "'" << logger_action::endl;
+
+                errors = prefetch_.get();
+                if (errors.empty()) {
+                    for (std::size_t i = 0; i < inputFields_.size(); ++i)
+                        copy_field(prefetchInputFields_[i].to_view(), inputFields_[i].field_view());
+                    for (std::size_t i = 0; i < referenceFields_.size(); ++i) {
+                        std::swap(referenceFields_[i].second, prefetchReferenceFields_[i]);
+                        timer.add_bytes(field_bytes(referenceFields_[i].second.to_view()));
+                    }
+                }
+            } else {
+                discard_prefetch();
+
+                serialization serialization(referenceSerializer_, referenceArchive_);
+
+                std::vector< std::pair< std::string, type_erased_field_view< T > > > referenceViews;
+                const bool stream = verificationSpecification_.stream_slab() > 0;
+                referenceStreamed_.assign(referenceFields_.size(), false);
+                for (std::size_t i = 0; i < referenceFields_.size(); ++i) {
+                    auto &refFieldPair = referenceFields_[i];
+
+                    // The shadow buffers of a prefetch are swapped with the reference fields, hence these are
+                    // only mapped if prefetching is disabled
+                    if (!verificationSpecification_.prefetch()) {
+                        refFieldPair.second = referenceStorage_[i];
+                        if (serialization.map(refFieldPair.first,
+                                iterations_[iteration].output,
+                                refFieldPair.second,
+                                stream,
+                                iterations_[iteration].outputPosition)) {
+                            referenceStreamed_[i] = stream;
+                            continue;
+                        }
+                    }
+                    referenceViews.emplace_back(refFieldPair.first, refFieldPair.second.to_view());
+                    timer.add_bytes(field_bytes(referenceViews.back().second));
+                }
 
-            auto inputSavepoint = iterations_[iteration].input;
-            auto refSavepoint = iterations_[iteration].output;
+                errors = load_fields(referenceSerializer_,
+                    referenceArchive_,
+                    iterations_[iteration],
+                    inputFields_,
+                    referenceViews,
+                    verificationSpecification_.num_threads());
+            }
 
-            try {
-                // Load input fields
-                VERIFICATION_LOG() << "Loading input savepoint '" << inputSavepoint << "'" << logger_action::endl;
+            if (!errors.empty()) {
+                std::string errorMessage;
+                for (const auto &error : errors)
+                    errorMessage += "\n - " + error;
+                error::fatal(boost::format("failed to load %i field(s) of iteration '%i':%s") % errors.size() %
+                             iteration % errorMessage);
+            }
 
-                for (auto &inputFieldPair : inputFields_)
-                    serialization.load(inputFieldPair.name(),
-                        inputFieldPair.field_view(),
-                        inputSavepoint,
-                        inputFieldPair.also_previous());
+            loadedIteration_ = iteration;
 
-                // Load reference fields
-                VERIFICATION_LOG() << "Loading reference savepoint '" << refSavepoint << "'" << logger_action::endl;
+            if (verificationSpecification_.prefetch() && iteration + 1 < (int)iterations_.size())
+                prefetch(iteration + 1);
 
-                for (auto &refFieldPair : referenceFields_)
-                    serialization.load(refFieldPair.first, refFieldPair.second.to_view(), refSavepoint);
-            } catch (verification_exception &e) {
-                error::fatal(e.what());
-            }
+            if (phase_statistics::get_instance().enabled())
+                stencilTimer_ = std::make_shared< phase_timer >("stencil");
         }
 
         /**
@@ -189,6 +300,25 @@ namespace gt_verification {
          * @return VerificationResult
          */
         verification_result verify(const error_metric_interface< T > &error_metric) {
+            return verify< error_metric_interface< T > >(error_metric);
+        }
+
+        /**
+         * @brief Verifies all output sources with a static error metric policy and collects the result
+         *
+         * Reference fields streamed from a Binary archive (see verification_specification::stream_slab()) are
+         * verified in slabs of k-layers and the pages of each slab are released afterwards. Accessing such a
+         * field later on (e.g. to report or write its failures) reads the pages again.
+         *
+         * The call is measured as the phase `verify` (see phase_statistics) with the bytes of the output and
+         * reference fields.
+         *
+         * @see verification::verify()
+         */
+        template < typename ErrorMetric >
+        verification_result verify(const ErrorMetric &error_metric) {
+            stencilTimer_.reset();
+            phase_timer timer("verify");
             verifications_.clear();
 
             verification_result totalResult(true, "\n");
@@ -197,9 +327,30 @@ namespace gt_verification {
             for (std::size_t i = 0; i < outputFields_.size(); ++i) {
                 verifications_.emplace_back(
                     outputFields_[i].second, referenceFields_[i].second.to_view(), boundaries_[i]);
+                verifications_.back().set_num_threads(verificationSpecification_.num_threads());
+                verifications_.back().set_max_failures(
+                    verificationSpecification_.max_failures_to_store(outputFields_[i].second.name()));
+                verifications_.back().set_worst_failures(verificationSpecification_.worst_failures());
+                if (i < referenceStreamed_.size() && referenceStreamed_[i]) {
+                    // A k-layer of the archive layout is contiguous
+                    const T *data = referenceFields_[i].second.data();
+                    const std::size_t kStride = referenceFields_[i].second.k_stride();
+                    verifications_.back().set_slabs(
+                        verificationSpecification_.stream_slab(), [data, kStride](int kBegin, int kEnd) {
+                            mapped_binary_archive::release(
+                                data + kBegin * kStride, sizeof(T) * (kEnd - kBegin) * kStride);
+                        });
+                }
 
                 // Perform actual verification and merge results
-                totalResult.merge(verifications_.back().verify(error_metric));
+                verification_result result = verifications_.back().verify(error_metric);
+                timer.add_bytes(2 * field_bytes(outputFields_[i].second));
+                if (!result.passed() && errorWriter_ && loadedIteration_ >= 0)
+                    errorWriter_->write_failure(outputFields_[i].first,
+                        outputFields_[i].second,
+                        referenceFields_[i].second.to_view(),
+                        iterations_[loadedIteration_].output);
+                totalResult.merge(result);
             }
             return totalResult;
         }
@@ -208,22 +359,33 @@ namespace gt_verification {
          * @brief Report failures depending on values set in VerificationReporter
          */
         void report_failures() const noexcept {
+            phase_timer timer("report_failures");
             verification_reporter verificationReporter(verificationSpecification_);
             for (const auto &verification : verifications_)
                 if (!verification) {
+                    // Written first as the reporter may exit (see verification_specification::stop_on_error())
+                    if (failureReport_)
+                        failureReport_->write(name_, verification);
                     verificationReporter.report(verification);
                 }
         }
 
+        /**
+         * @brief Get the verifications of the last call to verify() (one per output field)
+         */
+        const std::vector< verification< T > > &verifications() const noexcept { return verifications_; }
+
         /**
          * @brief Get the reference serializer
          */
         std::shared_ptr< ser::serializer > reference_serializer() const noexcept { return referenceSerializer_; }
 
         /**
-         * @brief Get the error serializer
+         * @brief Get the error serializer (it is opened if this has not happened yet)
          */
-        std::shared_ptr< ser::serializer > error_serializer() const noexcept { return errorSerializer_; }
+        std::shared_ptr< ser::serializer > error_serializer() const {
+            return errorWriter_ ? errorWriter_->serializer() : nullptr;
+        }
 
         /**
          * @brief Get a const reference of the iterations
@@ -231,18 +393,132 @@ namespace gt_verification {
         const std::vector< internal::savepoint_pair > &iterations() const noexcept { return iterations_; }
 
       private:
+        static std::size_t field_bytes(const type_erased_field_view< T > &field) noexcept {
+            return sizeof(T) * std::size_t(field.size());
+        }
+
+        /**
+         * @brief Load the input and reference fields of an iteration on @c numThreads threads
+         *
+         * Every thread takes the next field which has not been loaded yet.
+         *
+         * @return The failures as `field: message`, one per field which could not be loaded
+         */
+        static std::vector< std::string > load_fields(std::shared_ptr< ser::serializer > serializer,
+            std::shared_ptr< mapped_binary_archive > archive,
+            const internal::savepoint_pair &savepoints,
+            const std::vector< internal::input_field< T > > &inputFields,
+            const std::vector< std::pair< std::string, type_erased_field_view< T > > > &referenceFields,
+            int numThreads) {
+            serialization serialization(serializer, archive);
+
+            VERIFICATION_LOG_INFO() << "Loading input savepoint '" << savepoints.input << "' and reference savepoint '"
+                                    << savepoints.output << "'" << logger_action::endl;
+
+            // Fields [0, numInputFields) are input fields, the remaining ones are reference fields
+            const int numInputFields = inputFields.size();
+            const int numFields = numInputFields + referenceFields.size();
+
+            auto loadField = [&](int i) {
+                if (i < numInputFields) {
+                    const auto &inputField = inputFields[i];
+                    serialization.load(inputField.name(),
+                        inputField.field_view(),
+                        savepoints.input,
+                        inputField.also_previous(),
+                        savepoints.inputPosition);
+                } else {
+                    const auto &refFieldPair = referenceFields[i - numInputFields];
+                    serialization.load(
+                        refFieldPair.first, refFieldPair.second, savepoints.output, false, savepoints.outputPosition);
+                }
+            };
+            auto fieldName = [&](int i) {
+                return i < numInputFields ? inputFields[i].name() : referenceFields[i - numInputFields].first;
+            };
+
+            std::vector< std::string > fieldErrors(numFields);
+            std::atomic< int > nextField(0);
+            parallel_for_blocks(0, numFields, numThreads, [&](int, int, int) {
+                for (int i = nextField++; i < numFields; i = nextField++) {
+                    try {
+                        loadField(i);
+                    } catch (std::exception &e) {
+                        fieldErrors[i] = *e.what() ? e.what() : "unknown error";
+                    }
+                }
+            });
+
+            std::vector< std::string > errors;
+            for (int i = 0; i < numFields; ++i)
+                if (!fieldErrors[i].empty())
+                    errors.push_back(fieldName(i) + ": " + fieldErrors[i]);
+            return errors;
+        }
+
+        /**
+         * @brief Start loading @c iteration into the shadow buffers on a background thread
+         *
+         * The task only holds copies of the views and the serializer, i.e it does not refer to the collection.
+         */
+        void prefetch(int iteration) {
+            std::vector< internal::input_field< T > > inputFields;
+            for (std::size_t i = 0; i < inputFields_.size(); ++i)
+                inputFields.emplace_back(inputFields_[i].name(),
+                    prefetchInputFields_[i].to_view(),
+                    inputFields_[i].also_previous());
+
+            std::vector< std::pair< std::string, type_erased_field_view< T > > > referenceFields;
+            for (std::size_t i = 0; i < referenceFields_.size(); ++i)
+                referenceFields.emplace_back(referenceFields_[i].first, prefetchReferenceFields_[i].to_view());
+
+            prefetchIteration_ = iteration;
+            prefetch_ = std::async(std::launch::async,
+                &field_collection::load_fields,
+                referenceSerializer_,
+                referenceArchive_,
+                iterations_[iteration],
+                std::move(inputFields),
+                std::move(referenceFields),
+                verificationSpecification_.num_threads());
+        }
+
+        /**
+         * @brief Wait for a running prefetch and drop its result
+         */
+        void discard_prefetch() noexcept {
+            if (prefetch_.valid()) {
+                prefetch_.wait();
+                prefetch_ = std::future< std::vector< std::string > >();
+            }
+        }
+
         std::string name_;
         std::shared_ptr< ser::serializer > referenceSerializer_;
-        std::shared_ptr< ser::serializer > errorSerializer_;
+        std::shared_ptr< mapped_binary_archive > referenceArchive_;
+        std::shared_ptr< error_writer > errorWriter_;
+        std::shared_ptr< failure_report > failureReport_;
 
         std::vector< internal::savepoint_pair > iterations_;
+        int loadedIteration_ = -1;
 
         std::vector< internal::input_field< T > > inputFields_;
         std::vector< std::pair< std::string, type_erased_field_view< T > > > outputFields_;
         std::vector< std::pair< std::string, type_erased_field< T > > > referenceFields_;
+        std::vector< type_erased_field< T > > referenceStorage_; ///< Allocated reference fields (if not mapped)
+        std::vector< bool > referenceStreamed_;                  ///< Reference fields verified in slabs
+        std::shared_ptr< phase_timer > stencilTimer_;            ///< Started by load_iteration()
         std::vector< boundary_extent > boundaries_;
 
         verification_specification verificationSpecification_;
         std::vector< verification< T > > verifications_;
+
+        // Shadow buffers of the prefetched iteration
+        std::vector< type_erased_field< T > > prefetchInputFields_;
+        std::vector< type_erased_field< T > > prefetchReferenceFields_;
+        int prefetchIteration_ = -1;
+
+        // Declared last: destroying the collection waits for a running prefetch before the buffers are released
+        std::future< std::vector< std::string > > prefetch_;
     };
 }
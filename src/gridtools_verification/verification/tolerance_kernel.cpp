@@ -0,0 +1,47 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "tolerance_kernel.h"
+
+// Function multi-versioning: the compiler emits one clone per target and dispatches at load time
+// depending on the capabilities of the CPU. This file is compiled with -ffp-contract=off (see CMakeLists.txt) such
+// that the clones with FMA instructions round like the scalar error metrics.
+#if defined(__GNUC__) && (__GNUC__ >= 6) && !defined(__clang__) && !defined(__CUDACC__) && \
+    defined(__x86_64__) && defined(__linux__)
+#define GT_VERIFICATION_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define GT_VERIFICATION_TARGET_CLONES
+#endif
+
+namespace gt_verification {
+    namespace internal {
+
+        GT_VERIFICATION_TARGET_CLONES
+        int tolerance_check_n(const float *a, const float *b, int n, float rtol, float atol, bool *mask) noexcept {
+            return tolerance_check_n_impl(a, b, n, rtol, atol, mask);
+        }
+
+        GT_VERIFICATION_TARGET_CLONES
+        int tolerance_check_n(
+            const double *a, const double *b, int n, double rtol, double atol, bool *mask) noexcept {
+            return tolerance_check_n_impl(a, b, n, rtol, atol, mask);
+        }
+
+        GT_VERIFICATION_TARGET_CLONES
+        bool bitwise_identical_n(const float *a, const float *b, int n) noexcept {
+            return bitwise_identical_n_impl< float, std::uint32_t >(a, b, n);
+        }
+
+        GT_VERIFICATION_TARGET_CLONES
+        bool bitwise_identical_n(const double *a, const double *b, int n) noexcept {
+            return bitwise_identical_n_impl< double, std::uint64_t >(a, b, n);
+        }
+    } // namespace internal
+} // namespace gt_verification
@@ -0,0 +1,97 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "../common.h"
+
+namespace gt_verification {
+
+    namespace internal {
+
+        /**
+         * @brief Check `n` consecutive entries for |a - b| <= (atol + rtol * |b|)
+         *
+         * The result of each comparison is stored in `mask`, the loop is free of branches such that it
+         * can be vectorized by the compiler.
+         *
+         * @return Number of entries which are @b not equal within the tolerance
+         */
+        template < typename T >
+        inline int tolerance_check_n_impl(const T *a, const T *b, int n, T rtol, T atol, bool *mask) noexcept {
+            int mismatches = 0;
+            for (int i = 0; i < n; ++i) {
+                const bool equal = std::fabs(a[i] - b[i]) <= (atol + rtol * std::fabs(b[i]));
+                mask[i] = equal;
+                mismatches += !equal;
+            }
+            return mismatches;
+        }
+
+        /**
+         * @brief Batched tolerance check (see tolerance_check_n_impl)
+         *
+         * The float and double versions are compiled in AVX-512, AVX2 and generic variants (if supported by
+         * the compiler) and the best one is selected at runtime depending on the CPU.
+         * @{
+         */
+        template < typename T >
+        inline int tolerance_check_n(const T *a, const T *b, int n, T rtol, T atol, bool *mask) noexcept {
+            return tolerance_check_n_impl(a, b, n, rtol, atol, mask);
+        }
+
+        int tolerance_check_n(const float *a, const float *b, int n, float rtol, float atol, bool *mask) noexcept;
+
+        int tolerance_check_n(
+            const double *a, const double *b, int n, double rtol, double atol, bool *mask) noexcept;
+        /** @} */
+
+        /**
+         * @brief Check if `n` consecutive entries are bitwise identical and not NaN
+         *
+         * The bit patterns are XOR-ed and or-reduced which allows the compiler to vectorize the loop.
+         */
+        template < typename T, typename BitsType >
+        inline bool bitwise_identical_n_impl(const T *a, const T *b, int n) noexcept {
+            static_assert(sizeof(T) == sizeof(BitsType), "internal error: sizes do not match");
+            BitsType diff = 0;
+            int nans = 0;
+            for (int i = 0; i < n; ++i) {
+                BitsType x, y;
+                std::memcpy(&x, a + i, sizeof(BitsType));
+                std::memcpy(&y, b + i, sizeof(BitsType));
+                diff |= x ^ y;
+                nans |= (a[i] != a[i]);
+            }
+            return diff == 0 && nans == 0;
+        }
+
+        /**
+         * @brief Check if `n` consecutive entries are bitwise identical and not NaN (always false for types other
+         * than float and double)
+         *
+         * Identical entries are equal in every reflexive metric, hence they can skip the tolerance check. NaNs are
+         * excluded as they do not compare equal to themselves.
+         * @{
+         */
+        template < typename T >
+        inline bool bitwise_identical_n(const T *, const T *, int) noexcept {
+            return false;
+        }
+
+        bool bitwise_identical_n(const float *a, const float *b, int n) noexcept;
+
+        bool bitwise_identical_n(const double *a, const double *b, int n) noexcept;
+        /** @} */
+    } // namespace internal
+} // namespace gt_verification
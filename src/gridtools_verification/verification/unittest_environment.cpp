@@ -22,8 +22,37 @@ namespace gt_verification {
 
     void unittest_environment::TearDown() {
         print_skipped_tests();
+
+        const reference_cache &cache = reference_cache::get_instance();
+        if (cache.enabled())
+            VERIFICATION_LOG() << boost::format("Reference cache: %i hit(s), %i miss(es), %i MB held") % cache.hits() %
+                                      cache.misses() % (cache.size() >> 20)
+                               << logger_action::endl;
         reference_serializer_.reset();
-        error_serializer_.reset();
+        reference_savepoints_.reset();
+        reference_archive_.reset();
+        error_writer_->flush();
+        error_writer_.reset();
+        failure_report_.reset();
+
+        // Written after the error writer has finished its serialization
+        const phase_statistics &timing = phase_statistics::get_instance();
+        if (timing.enabled()) {
+            if (timing_path_.empty())
+                timing.print(stdout);
+            else
+                timing.write_csv(timing_path_);
+        }
+    }
+
+    void unittest_environment::enable_timing(const std::string &csvPath) {
+        timing_path_ = csvPath;
+        phase_statistics &timing = phase_statistics::get_instance();
+        timing.set_scope_function([this]() {
+            // Phases outside of a test (e.g. a prefetch which is still running) are accumulated without a name
+            return ::testing::UnitTest::GetInstance()->current_test_info() ? test_name() : std::string();
+        });
+        timing.enable();
     }
 
     std::string unittest_environment::test_name() const noexcept {
@@ -36,9 +36,24 @@ namespace gt_verification {
             // Initialize the serializer
             reference_serializer_ =
                 std::make_shared< ser::serializer >(ser::open_mode::Read, data_path_, data_name, archive_type);
+            reference_savepoints_ = std::make_shared< savepoint_index >(*reference_serializer_);
+            reference_archive_ =
+                mapped_binary_archive::open(reference_serializer_->directory(), reference_serializer_->prefix());
 
-            // Initialize error serializer
-            error_serializer_ = std::make_shared< ser::serializer >(ser::open_mode::Write, ".", "Error");
+            // Initialize error writer (the error serializer is only opened when the first failure is written)
+            error_writer_ = std::make_shared< error_writer >(
+                []() { return std::make_shared< ser::serializer >(ser::open_mode::Write, ".", "Error"); },
+                verification_specification(cl_).dump_limit());
+
+            // Initialize the failure report (if requested)
+            verification_specification verifSpec(cl_);
+            if (!verifSpec.report_path().empty())
+                failure_report_ =
+                    std::make_shared< failure_report >(verifSpec.report_path(), verifSpec.report_file_format());
+
+            // Measure the phases of each test (if requested)
+            if (cl_.has("timing"))
+                enable_timing(cl_.as< std::string >("timing"));
         };
 
         static unittest_environment &get_instance();
@@ -55,6 +70,14 @@ namespace gt_verification {
          */
         void print_skipped_tests() const noexcept;
 
+        /**
+         * @brief Measure the phases of the field collections per test (see phase_statistics)
+         *
+         * The phases are accumulated under test_name() and printed by TearDown(), or written as CSV to
+         * @c csvPath if it is not empty.
+         */
+        void enable_timing(const std::string &csvPath = "");
+
         /**
          * @brief SetUp the global test environment (called by GTest)
          */
@@ -73,11 +96,25 @@ namespace gt_verification {
         std::shared_ptr< ser::serializer > reference_serializer() const noexcept { return reference_serializer_; }
 
         /**
-         * @brief Get the error serialbox serializer
+         * @brief Get the index of the savepoints of the reference serializer
+         *
+         * The index is shared by all collections created by create_field_collection().
+         */
+        std::shared_ptr< savepoint_index > reference_savepoints() const noexcept { return reference_savepoints_; }
+
+        /**
+         * @brief Get the mapped Binary archive of the reference serializer (@c nullptr if it cannot be mapped)
+         *
+         * The archive is shared by all collections created by create_field_collection().
+         */
+        std::shared_ptr< mapped_binary_archive > reference_archive() const noexcept { return reference_archive_; }
+
+        /**
+         * @brief Get the error serialbox serializer (it is opened if this has not happened yet)
          *
          * @see Serialization
          */
-        std::shared_ptr< ser::serializer > error_serializer() const noexcept { return error_serializer_; }
+        std::shared_ptr< ser::serializer > error_serializer() const { return error_writer_->serializer(); }
 
         /**
          * @brief Initializes and returns a collection for the tests
@@ -98,9 +135,11 @@ namespace gt_verification {
             VERIFICATION_LOG() << "Creating field collection for '" << spname << "'" << logger_action::endl;
 
             verification_specification verifSpec(cl_);
-            field_collection< T > collection(verifSpec);
-            collection.attach_reference_serializer(reference_serializer(), spname + "-in", spname + "-out");
-            collection.attach_error_serializer(error_serializer());
+            field_collection< T > collection(verifSpec, spname);
+            collection.attach_reference_serializer(
+                reference_serializer(), spname + "-in", spname + "-out", reference_savepoints(), reference_archive());
+            collection.attach_error_writer(error_writer_);
+            collection.attach_failure_report(failure_report_);
 
             if (collection.iterations().size() == 0) {
                 cprintf(color::YELLOW, "[   SKIP   ]");
@@ -138,6 +177,17 @@ namespace gt_verification {
         template < typename T >
         testing::AssertionResult verify_collection(
             field_collection< T > &fieldCollection, const error_metric_interface< T > &errorMetric) {
+            return verify_collection< T, error_metric_interface< T > >(fieldCollection, errorMetric);
+        }
+
+        /**
+         * @brief Verifies a field collection with a static error metric policy
+         *
+         * @see verification::verify()
+         */
+        template < typename T, typename ErrorMetric >
+        testing::AssertionResult verify_collection(
+            field_collection< T > &fieldCollection, const ErrorMetric &errorMetric) {
             verification_result result = fieldCollection.verify(errorMetric);
             if (!result.passed())
                 fieldCollection.report_failures();
@@ -152,7 +202,11 @@ namespace gt_verification {
 
         // Serializer objects
         std::shared_ptr< ser::serializer > reference_serializer_;
-        std::shared_ptr< ser::serializer > error_serializer_;
+        std::shared_ptr< savepoint_index > reference_savepoints_;
+        std::shared_ptr< mapped_binary_archive > reference_archive_;
+        std::shared_ptr< error_writer > error_writer_;
+        std::shared_ptr< failure_report > failure_report_;
+        std::string timing_path_;
 
         // List of skipped tests
         std::vector< std::string > skipped_;
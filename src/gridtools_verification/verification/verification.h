@@ -19,14 +19,88 @@
 
 #include "../common.h"
 #include "../core/include_boost_format.h"
+#include "../core/loop_nest.h"
+#include "../core/parallel.h"
 #include "../core/type_erased_field.h"
 #include "boundary_extent.h"
 #include "error_metric.h"
+#include "error_statistics.h"
 #include "verification_result.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <tuple>
 #include <vector>
 
 namespace gt_verification {
 
+    namespace internal {
+
+        /**
+         * Non-virtual accessor of a strided field (see type_erased_field_view::is_strided())
+         */
+        template < typename T >
+        class strided_field_accessor {
+          public:
+            strided_field_accessor(const gt_verification::type_erased_field_view< T > &field)
+                : data_(field.data()), iStride_(field.i_stride()), jStride_(field.j_stride()),
+                  kStride_(field.k_stride()) {}
+
+            const T &operator()(int i, int j, int k) const noexcept {
+                return data_[i * iStride_ + j * jStride_ + k * kStride_];
+            }
+
+          private:
+            const T *data_;
+            int iStride_, jStride_, kStride_;
+        };
+
+        /**
+         * Access a row of a field starting at position start along dimension dim through operator[]
+         */
+        template < typename T, typename FieldAccessor >
+        struct row_accessor {
+            const FieldAccessor &field;
+            std::array< int, 3 > start;
+            int dim;
+
+            T operator[](int n) const noexcept {
+                std::array< int, 3 > pos = start;
+                pos[dim] += n;
+                return field(pos[0], pos[1], pos[2]);
+            }
+        };
+
+        /**
+         * Batched comparison of a metric, uses `ErrorMetric::equal_n` if available
+         * @{
+         */
+        template < typename ErrorMetric, typename T >
+        auto metric_equal_n_impl(const ErrorMetric &error_metric, const T *a, const T *b, int n, bool *mask, int)
+            -> decltype(error_metric.equal_n(a, b, n, mask)) {
+            return error_metric.equal_n(a, b, n, mask);
+        }
+
+        template < typename ErrorMetric, typename T >
+        int metric_equal_n_impl(const ErrorMetric &error_metric, const T *a, const T *b, int n, bool *mask, long) {
+            int mismatches = 0;
+            for (int i = 0; i < n; ++i) {
+                mask[i] = error_metric.equal(a[i], b[i]);
+                mismatches += !mask[i];
+            }
+            return mismatches;
+        }
+
+        template < typename ErrorMetric, typename T >
+        int metric_equal_n(const ErrorMetric &error_metric, const T *a, const T *b, int n, bool *mask) {
+            return metric_equal_n_impl(error_metric, a, b, n, mask, 0);
+        }
+        /** @} */
+    } // namespace internal
+
     /**
      * @brief Verify if an output field (produced by a stencil) and a reference field (loaded from disk)
      * are equal within a given @ref ErrorMetric "error metric".
@@ -62,7 +136,8 @@ namespace gt_verification {
         verification(type_erased_field_view< T > outputField,
             type_erased_field_view< T > referenceField,
             boundary_extent boundary = boundary_extent())
-            : outputField_(outputField), referenceField_(referenceField), boundary_(boundary) {}
+            : outputField_(outputField), referenceField_(referenceField), boundary_(boundary), numThreads_(1),
+              maxFailures_(-1), slabSize_(0), numWorst_(0), numFailures_(0) {}
 
         /**
          * @brief Verify that outputField is equal to refrenceField within the given error metric
@@ -72,10 +147,33 @@ namespace gt_verification {
          * @return VerificationResult
          */
         verification_result verify(const error_metric_interface< T > &error_metric) noexcept {
+            return verify< error_metric_interface< T > >(error_metric);
+        }
+
+        /**
+         * @brief Verify that outputField is equal to refrenceField within the given error metric policy
+         *
+         * The metric is resolved at compile time, hence any type providing `bool equal(T a, T b) const` (and
+         * optionally `int equal_n(const T *a, const T *b, int n, bool *mask) const`, see
+         * error_metric_interface) can be used and its checks can be inlined into the verification loop.
+         *
+         * Contiguous rows which are bitwise identical to the reference (and contain no NaNs) are accepted
+         * without consulting the metric, i.e. the metric is assumed to be reflexive.
+         *
+         * This function discards all previous recorded failures.
+         *
+         * @return VerificationResult
+         */
+        template < typename ErrorMetric >
+        verification_result verify(const ErrorMetric &error_metric) noexcept {
             // Sync field with Host
             outputField_.sync();
 
             failures_.clear();
+            numFailures_ = 0;
+            statistics_ = error_statistics();
+            worstAbsolute_.clear();
+            worstRelative_.clear();
 
             std::string nameOut = outputField_.name();
             std::string nameRef = referenceField_.name();
@@ -98,28 +196,159 @@ namespace gt_verification {
                         kSizeRef)
                         .str());
 
-            // Verify fields
-            for (int k = boundary_.k_minus(); k < (kSizeOut + boundary_.k_plus()); ++k)
-                for (int j = boundary_.j_minus(); j < (jSizeOut + boundary_.j_plus()); ++j)
-                    for (int i = boundary_.i_minus(); i < (iSizeOut + boundary_.i_plus()); ++i)
-                        if (!error_metric.equal(outputField_(i, j, k), referenceField_(i, j, k)))
-                            failures_.push_back(failure{i, j, k, outputField_(i, j, k), referenceField_(i, j, k)});
+            // Verify fields, regular storages are accessed directly through their strides while exotic storages
+            // fall back to the element access of the view. The loops are nested according to the layout of the
+            // output field, i.e. the innermost loop runs along its unit-stride dimension (such contiguous rows
+            // are checked in batches), and the outermost dimension is split into blocks which are verified
+            // concurrently (only for strided storages).
+            const bool strided = outputField_.is_strided() && referenceField_.is_strided();
+            const std::array< int, 3 > outStrides = strides_of(outputField_);
+            const std::array< int, 3 > refStrides = strides_of(referenceField_);
+            const loop_nest nest = strided ? loop_nest(outStrides[0], outStrides[1], outStrides[2]) : loop_nest();
+            const loop_nest refNest = strided ? loop_nest(refStrides[0], refStrides[1], refStrides[2]) : loop_nest();
+            const bool rows = strided && outStrides[nest.inner()] == 1 && refStrides[nest.inner()] == 1;
+
+            // Tile the outer loops if the reference field is laid out differently
+            const int tileSize = refNest.inner() != nest.inner() ? 16 : 0;
+
+            const std::array< int, 3 > begin{{boundary_.i_minus(), boundary_.j_minus(), boundary_.k_minus()}};
+            const std::array< int, 3 > end{{iSizeOut + boundary_.i_plus(),
+                jSizeOut + boundary_.j_plus(),
+                kSizeOut + boundary_.k_plus()}};
+            const int outer = nest.outer();
+            const int numThreads = strided ? numThreads_ : 1;
+
+            worst_heap worstAbsolute(numWorst_), worstRelative(numWorst_);
+
+            // The k-layers are verified in slabs (a single one if no slab size is set)
+            const int slabSize = slabSize_ > 0 ? slabSize_ : std::max(1, end[2] - begin[2]);
+            for (int slabBegin = begin[2]; slabBegin < end[2]; slabBegin += slabSize) {
+                std::array< int, 3 > slabFirst = begin, slabLast = end;
+                slabFirst[2] = slabBegin;
+                slabLast[2] = std::min(slabBegin + slabSize, end[2]);
+
+                std::vector< block_result > blockResults(num_blocks(slabFirst[outer], slabLast[outer], numThreads),
+                    block_result(max_failures_to_store(), nest.is_canonical(), numWorst_));
+                parallel_for_blocks(
+                    slabFirst[outer], slabLast[outer], numThreads, [&](int block, int blockBegin, int blockEnd) {
+                        std::array< int, 3 > first = slabFirst, last = slabLast;
+                        first[outer] = blockBegin;
+                        last[outer] = blockEnd;
+
+                        auto &result = blockResults[block];
+                        if (rows)
+                            verify_rows_impl(error_metric, nest, first, last, result);
+                        else if (strided)
+                            verify_impl(internal::strided_field_accessor< T >(outputField_),
+                                internal::strided_field_accessor< T >(referenceField_),
+                                error_metric,
+                                nest,
+                                first,
+                                last,
+                                tileSize,
+                                result);
+                        else
+                            verify_impl(outputField_, referenceField_, error_metric, nest, first, last, 0, result);
+                    });
+
+                // Merge the blocks, the stored failures are the first ones in (k, j, i) order. The failures of a
+                // slab follow those of the previous slabs in this order, hence only the new ones need sorting.
+                const std::size_t numStored = failures_.size();
+                for (auto &blockResult : blockResults) {
+                    failures_.insert(failures_.end(), blockResult.failures.begin(), blockResult.failures.end());
+                    numFailures_ += blockResult.numFailures;
+                    statistics_.merge(blockResult.statistics);
+                    worstAbsolute.merge(blockResult.worstAbsolute);
+                    worstRelative.merge(blockResult.worstRelative);
+                }
+                if (!nest.is_canonical())
+                    std::sort(failures_.begin() + numStored, failures_.end(), kji_less);
+                if (failures_.size() > max_failures_to_store())
+                    failures_.resize(max_failures_to_store());
+
+                if (slabDone_)
+                    slabDone_(slabFirst[2], slabLast[2]);
+            }
+
+            worstAbsolute_ = worstAbsolute.sorted();
+            worstRelative_ = worstRelative.sorted();
 
             outputField_.sync();
 
-            if (failures_.empty())
+            if (numFailures_ == 0)
                 return verification_result(true, "");
             else
                 return verification_result(false,
                     (boost::format("%5.3f %% of field entries of '%s' do not match (total of %i)") %
-                        (100 * T(failures_.size()) / outputField_.size()) % nameOut % failures_.size())
+                        (100 * T(numFailures_) / outputField_.size()) % nameOut % numFailures_)
                         .str());
         }
 
+        /**
+         * @brief Set the number of threads used by verify() (default: 1)
+         */
+        void set_num_threads(int numThreads) noexcept { numThreads_ = std::max(1, numThreads); }
+
+        /**
+         * @brief Number of threads used by verify()
+         */
+        int num_threads() const noexcept { return numThreads_; }
+
+        /**
+         * @brief Verify the k-layers in slabs of @c slabSize layers (0 verifies all layers at once, default)
+         *
+         * After a slab [kBegin, kEnd) is verified, `slabDone(kBegin, kEnd)` is invoked (if given), e.g. to release
+         * the memory of the reference field held by the slab.
+         */
+        void set_slabs(int slabSize, std::function< void(int, int) > slabDone = nullptr) {
+            slabSize_ = std::max(0, slabSize);
+            slabDone_ = slabDone;
+        }
+
+        /**
+         * @brief Number of k-layers verified at once (0 if all layers are verified at once)
+         */
+        int slab_size() const noexcept { return slabSize_; }
+
+        /**
+         * @brief Track the @c numWorst failures with the largest absolute and relative error in verify()
+         *
+         * The failures are kept in bounded heaps while verifying, i.e. at most @c numWorst failures per kind
+         * are held independently of max_failures() (default: 0, nothing is tracked).
+         *
+         * @see worst_absolute_failures()
+         * @see worst_relative_failures()
+         */
+        void set_worst_failures(int numWorst) noexcept { numWorst_ = std::max(0, numWorst); }
+
+        /**
+         * @brief Number of failures with the largest errors tracked by verify()
+         */
+        int worst_failures() const noexcept { return numWorst_; }
+
+        /**
+         * @brief Limit the number of failures stored by verify()
+         *
+         * All failures are counted (see num_failures()) but only the first @c maxFailures (in (k, j, i) order)
+         * are stored. A value of 0 only counts the failures while a negative value stores all of them
+         * (default).
+         */
+        void set_max_failures(int maxFailures) noexcept { maxFailures_ = maxFailures; }
+
+        /**
+         * @brief Maximum number of failures stored by verify() (negative if all are stored)
+         */
+        int max_failures() const noexcept { return maxFailures_; }
+
+        /**
+         * @brief Total number of failures of the last verify(), including the ones not stored
+         */
+        std::size_t num_failures() const noexcept { return numFailures_; }
+
         /**
          * @brief Return true if errors occurred
          */
-        bool has_errors() const noexcept { return !failures_.empty(); }
+        bool has_errors() const noexcept { return numFailures_ != 0; }
 
         /**
          * @brief Converts to true iff no errors occured
@@ -142,9 +371,35 @@ namespace gt_verification {
 
         /**
          * @brief Get the vector of @ref Failure "failures".
+         *
+         * This contains at most max_failures() entries. A verification created by field_collection only stores
+         * the failures which are going to be reported (see verification_specification::max_failures_to_store()),
+         * i.e. none at all unless they are listed, visualized or written to a failure report. Use num_failures()
+         * for the number of failures.
          */
         const std::vector< failure > &failures() const noexcept { return failures_; }
 
+        /**
+         * @brief Failures with the largest absolute error |out - ref| in decreasing order (see set_worst_failures())
+         *
+         * NaNs are ranked first, ties are ordered by position in (k, j, i) order.
+         */
+        const std::vector< failure > &worst_absolute_failures() const noexcept { return worstAbsolute_; }
+
+        /**
+         * @brief Failures with the largest relative error |out - ref| / |ref| in decreasing order
+         *
+         * A failure with a reference of zero has an infinite relative error.
+         *
+         * @see worst_absolute_failures()
+         */
+        const std::vector< failure > &worst_relative_failures() const noexcept { return worstRelative_; }
+
+        /**
+         * @brief Get the @ref error_statistics "statistics" of the error, computed during verify()
+         */
+        const error_statistics &statistics() const noexcept { return statistics_; }
+
         /**
          * @brief Get a view to the output-field
          */
@@ -156,10 +411,231 @@ namespace gt_verification {
         type_erased_field_view< T > reference_field() const noexcept { return referenceField_; }
 
       private:
+        static bool kji_less(const failure &a, const failure &b) noexcept {
+            return std::tie(a.k, a.j, a.i) < std::tie(b.k, b.j, b.i);
+        }
+
+        static std::array< int, 3 > strides_of(const type_erased_field_view< T > &field) noexcept {
+            return {{field.i_stride(), field.j_stride(), field.k_stride()}};
+        }
+
+        /**
+         * Bounded min-heap of the failures with the largest error (the least severe one is on top)
+         */
+        class worst_heap {
+          public:
+            explicit worst_heap(std::size_t capacity) : capacity_(capacity) {}
+
+            bool enabled() const noexcept { return capacity_ > 0; }
+
+            void push(double error, const failure &f) {
+                if (std::isnan(error))
+                    error = std::numeric_limits< double >::infinity();
+                const entry e{error, f};
+                if (entries_.size() < capacity_) {
+                    entries_.push_back(e);
+                    std::push_heap(entries_.begin(), entries_.end(), more_severe);
+                } else if (capacity_ > 0 && more_severe(e, entries_.front())) {
+                    std::pop_heap(entries_.begin(), entries_.end(), more_severe);
+                    entries_.back() = e;
+                    std::push_heap(entries_.begin(), entries_.end(), more_severe);
+                }
+            }
+
+            void merge(const worst_heap &other) {
+                for (const auto &e : other.entries_)
+                    push(e.error, e.f);
+            }
+
+            /**
+             * Failures ordered by decreasing error
+             */
+            std::vector< failure > sorted() const {
+                std::vector< entry > entries(entries_);
+                std::sort(entries.begin(), entries.end(), more_severe);
+                std::vector< failure > failures;
+                failures.reserve(entries.size());
+                for (const auto &e : entries)
+                    failures.push_back(e.f);
+                return failures;
+            }
+
+          private:
+            struct entry {
+                double error;
+                failure f;
+            };
+
+            // Ties are resolved in favour of the first position in (k, j, i) order, which makes the selection
+            // independent of the order in which the failures are pushed
+            static bool more_severe(const entry &a, const entry &b) noexcept {
+                return a.error > b.error || (a.error == b.error && kji_less(a.f, b.f));
+            }
+
+            std::size_t capacity_;
+            std::vector< entry > entries_;
+        };
+
+        /**
+         * Failures of a block of the outermost dimension
+         *
+         * If the block is traversed in (k, j, i) order the first failures are stored, otherwise the stored
+         * failures are kept in a max-heap such that the first ones in (k, j, i) order are retained.
+         */
+        struct block_result {
+            block_result(std::size_t maxFailures, bool ordered, std::size_t numWorst)
+                : numFailures(0), maxFailures(maxFailures), ordered(ordered), worstAbsolute(numWorst),
+                  worstRelative(numWorst) {}
+
+            /**
+             * No further failure can be stored
+             */
+            bool full() const noexcept {
+                return failures.size() >= maxFailures && (ordered || maxFailures == 0);
+            }
+
+            void store(const failure &f) {
+                if (failures.size() < maxFailures) {
+                    failures.push_back(f);
+                    if (!ordered && failures.size() == maxFailures)
+                        std::make_heap(failures.begin(), failures.end(), kji_less);
+                } else if (!full() && kji_less(f, failures.front())) {
+                    std::pop_heap(failures.begin(), failures.end(), kji_less);
+                    failures.back() = f;
+                    std::push_heap(failures.begin(), failures.end(), kji_less);
+                }
+            }
+
+            /**
+             * The failures with the largest errors are tracked
+             */
+            bool tracking() const noexcept { return worstAbsolute.enabled(); }
+
+            void track(const failure &f) {
+                const double absError = std::fabs(double(f.outVal) - double(f.refVal));
+                worstAbsolute.push(absError, f);
+                worstRelative.push(
+                    f.refVal != 0 ? absError / std::fabs(double(f.refVal)) : std::numeric_limits< double >::infinity(),
+                    f);
+            }
+
+            void record(int i, int j, int k, T outVal, T refVal) {
+                ++numFailures;
+                statistics.add_mismatches(k, 1);
+                store(failure{i, j, k, outVal, refVal});
+                if (tracking())
+                    track(failure{i, j, k, outVal, refVal});
+            }
+
+            std::vector< failure > failures;
+            std::size_t numFailures;
+            std::size_t maxFailures;
+            bool ordered;
+            error_statistics statistics;
+            worst_heap worstAbsolute;
+            worst_heap worstRelative;
+        };
+
+        std::size_t max_failures_to_store() const noexcept {
+            return maxFailures_ < 0 ? std::numeric_limits< std::size_t >::max()
+                                    : static_cast< std::size_t >(maxFailures_);
+        }
+
+        template < typename FieldAccessor, typename ErrorMetric >
+        void verify_impl(const FieldAccessor &output,
+            const FieldAccessor &reference,
+            const ErrorMetric &error_metric,
+            const loop_nest &nest,
+            const std::array< int, 3 > &begin,
+            const std::array< int, 3 > &end,
+            int tileSize,
+            block_result &result) const {
+            using row_t = internal::row_accessor< T, FieldAccessor >;
+            const int dim = nest.inner();
+
+            for_each_row(begin,
+                end,
+                nest,
+                [&](const std::array< int, 3 > &start, int n) {
+                    std::array< int, 3 > pos = start;
+                    for (int idx = 0; idx < n; ++idx, ++pos[dim]) {
+                        const T outVal = output(pos[0], pos[1], pos[2]);
+                        const T refVal = reference(pos[0], pos[1], pos[2]);
+                        if (!error_metric.equal(outVal, refVal))
+                            result.record(pos[0], pos[1], pos[2], outVal, refVal);
+                    }
+                    result.statistics.add_row(row_t{output, start, dim}, row_t{reference, start, dim}, n, start, dim);
+                },
+                tileSize);
+        }
+
+        template < typename ErrorMetric >
+        void verify_rows_impl(const ErrorMetric &error_metric,
+            const loop_nest &nest,
+            const std::array< int, 3 > &begin,
+            const std::array< int, 3 > &end,
+            block_result &result) const {
+            const int dim = nest.inner();
+            const int rowSize = end[dim] - begin[dim];
+            if (rowSize <= 0)
+                return;
+
+            const T *outData = outputField_.data();
+            const T *refData = referenceField_.data();
+            const std::array< int, 3 > outStrides = strides_of(outputField_);
+            const std::array< int, 3 > refStrides = strides_of(referenceField_);
+
+            std::unique_ptr< bool[] > mask(new bool[rowSize]);
+
+            for_each_row(begin, end, nest, [&](const std::array< int, 3 > &start, int n) {
+                const T *outRow = outData + start[0] * outStrides[0] + start[1] * outStrides[1] +
+                                  start[2] * outStrides[2];
+                const T *refRow = refData + start[0] * refStrides[0] + start[1] * refStrides[1] +
+                                  start[2] * refStrides[2];
+
+                // Fast path for rows which are bitwise identical to the reference
+                if (internal::bitwise_identical_n(outRow, refRow, n)) {
+                    result.statistics.add_identical(n);
+                    return;
+                }
+
+                const int mismatches = internal::metric_equal_n(error_metric, outRow, refRow, n, mask.get());
+                result.statistics.add_row(outRow, refRow, n, start, dim);
+                if (mismatches == 0)
+                    return;
+
+                result.numFailures += mismatches;
+                if (dim == 2) {
+                    for (int idx = 0; idx < n; ++idx)
+                        if (!mask[idx])
+                            result.statistics.add_mismatches(start[2] + idx, 1);
+                } else
+                    result.statistics.add_mismatches(start[2], mismatches);
+
+                std::array< int, 3 > pos = start;
+                for (int idx = 0; idx < n && (!result.full() || result.tracking()); ++idx, ++pos[dim])
+                    if (!mask[idx]) {
+                        const failure f{pos[0], pos[1], pos[2], outRow[idx], refRow[idx]};
+                        result.store(f);
+                        if (result.tracking())
+                            result.track(f);
+                    }
+            });
+        }
+
         type_erased_field_view< T > outputField_;
         type_erased_field_view< T > referenceField_;
         boundary_extent boundary_;
+        int numThreads_;
+        int maxFailures_;
+        int slabSize_;
+        std::function< void(int, int) > slabDone_;
+        int numWorst_;
 
         std::vector< failure > failures_;
+        std::vector< failure > worstAbsolute_;
+        std::vector< failure > worstRelative_;
+        std::size_t numFailures_;
+        error_statistics statistics_;
     };
 } // namespace gt_verification
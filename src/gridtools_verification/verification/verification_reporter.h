@@ -16,8 +16,10 @@
 #include "../core/error.h"
 #include "../core/include_boost_format.h"
 #include "../core/utility.h"
+#include "failure_regions.h"
 #include "verification.h"
 #include "verification_specification.h"
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <initializer_list>
@@ -51,6 +53,17 @@ namespace gt_verification {
         void mark(int i, int j) { error_mask_[i * size_j_ + j] = true; }
     };
 
+    // Failures of a single layer (a sub-range of the failures of a verification)
+    template < typename Iterator >
+    struct failure_range {
+        Iterator first, last;
+
+        Iterator begin() const { return first; }
+        Iterator end() const { return last; }
+        Iterator cbegin() const { return first; }
+        Iterator cend() const { return last; }
+    };
+
     // Print a layer
     template < typename failures_t >
     void printLayer(error_layer const &layer, failures_t const &failures, int k, std::string const &field_name) {
@@ -97,6 +110,7 @@ namespace gt_verification {
                 return;
 
             const auto &failures = verif.failures();
+            const std::vector< bool > layerMask = layer_mask(verif.output_field().k_size());
             int curErrors = 0;
 
             if (!failures.empty()) {
@@ -106,17 +120,20 @@ namespace gt_verification {
                 std::cout << std::string(67, '-') << "\n";
 
                 for (const auto &fail : failures) {
-                    // Check if we only print from a specific k-layer (this is definitly not the smartest
-                    // way of doing this :)
-                    if (verifSpec_.k_interval_specified())
-                        if (std::count(verifSpec_.k_interval().begin(), verifSpec_.k_interval().end(), fail.k) == 0)
-                            continue;
+                    // Check if we only print from specific k-layers
+                    if (!layerMask[fail.k])
+                        continue;
 
                     // Print errors (no more than maxErrorsToList)
-                    if (curErrors++ < verifSpec_.max_errors_to_list())
-                        std::cout << boost::format("(%3i,%3i,%3i) | %24.12f | %24.12f\n") % fail.i % fail.j % fail.k %
-                                         fail.outVal % fail.refVal;
+                    if (curErrors++ >= verifSpec_.max_errors_to_list())
+                        break;
+                    std::cout << boost::format("(%3i,%3i,%3i) | %24.12f | %24.12f\n") % fail.i % fail.j % fail.k %
+                                     fail.outVal % fail.refVal;
                 }
+
+                if (verif.num_failures() > failures.size())
+                    std::cout << boost::format("(only the first %i of %i failures were recorded)\n") %
+                                     failures.size() % verif.num_failures();
                 std::cout << std::endl;
             }
         }
@@ -130,29 +147,127 @@ namespace gt_verification {
             type_erased_field_view< T > referenceField = verif.reference_field();
             type_erased_field_view< T > outputField = verif.output_field();
 
-            // If the interval is not specified, we will print everything. Note: this may trigger some
-            // unnecessary copies but it doesn't really matter here.
-            std::vector< int > kInterval;
-            if (!verifSpec_.k_interval_specified()) {
-                kInterval.resize(referenceField.k_size());
-                std::iota(kInterval.begin(), kInterval.end(), 0);
-            } else
-                kInterval = verifSpec_.k_interval();
+            // The failures are stored in (k, j, i) order, hence the failures of a layer are contiguous. Bucket
+            // them by k in a single pass: the failures of layer k are [offsets[k], offsets[k + 1]).
+            const int kSize = referenceField.k_size();
+            std::vector< std::size_t > offsets(kSize + 1, 0);
+            for (const auto &fail : failures)
+                ++offsets[fail.k + 1];
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            // Iterate over the specified layers (k-direction), layers without mismatches are skipped
+            const std::vector< bool > layerMask = layer_mask(kSize);
+            for (int k = 0; k < kSize; ++k) {
+                if (!layerMask[k] || offsets[k] == offsets[k + 1])
+                    continue;
+
+                failure_range< decltype(failures.cbegin()) > kFailures{
+                    failures.cbegin() + offsets[k], failures.cbegin() + offsets[k + 1]};
+                error_layer layer{referenceField.i_size(), referenceField.j_size(), kFailures};
+                printLayer(layer, kFailures, k, outputField.name());
+            }
+        }
 
-            // Iterate over the specified layers (k-direction)
-            for (auto k : kInterval) {
+        template < typename T >
+        void print_regions(const verification< T > &verif) const noexcept {
+            if (!verifSpec_.fieldname().empty() && verif.output_field().name() != verifSpec_.fieldname())
+                return;
 
-                std::vector< typename gt_verification::verification< T >::failure > k_failures;
-                std::copy_if(failures.cbegin(),
-                    failures.cend(),
-                    std::back_inserter(k_failures),
-                    [k](typename gt_verification::verification< T >::failure const &f) { return f.k == k; });
+            const auto regions = find_failure_regions(verif.failures());
+            if (regions.empty())
+                return;
 
-                if (k_failures.size() > 0) {
-                    error_layer layer{referenceField.i_size(), referenceField.j_size(), k_failures};
-                    printLayer(layer, k_failures, k, outputField.name());
+            std::cout << boost::format("%i failing region(s) of '%s' (%i failures)\n") % regions.size() %
+                             verif.output_field().name() % verif.failures().size();
+            std::cout << boost::format("%13s   %13s | %10s | %24s\n") % "From" % "To" % "Points" % "Max. abs. error at";
+            std::cout << std::string(80, '-') << "\n";
+            for (const auto &region : regions)
+                std::cout << boost::format("(%3i,%3i,%3i) - (%3i,%3i,%3i) | %10i | %.6e (%3i,%3i,%3i)\n") %
+                                 region.iMin % region.jMin % region.kMin % region.iMax % region.jMax % region.kMax %
+                                 region.numPoints % region.maxAbsError % region.worstI % region.worstJ %
+                                 region.worstK;
+            std::cout << std::endl;
+        }
+
+        template < typename T >
+        void print_worst_failures(const verification< T > &verif) const noexcept {
+            if (!verifSpec_.fieldname().empty() && verif.output_field().name() != verifSpec_.fieldname())
+                return;
+
+            auto printTable = [&](const char *title, const std::vector< typename verification< T >::failure > &worst) {
+                if (worst.empty())
+                    return;
+                std::cout << boost::format("%s of '%s'\n") % title % verif.output_field().name();
+                std::cout << boost::format("%13s | %24s | %24s | %13s | %13s\n") % "Position" % "Actual" %
+                                 "Reference" % "Abs. error" % "Rel. error";
+                std::cout << std::string(99, '-') << "\n";
+                for (const auto &fail : worst) {
+                    const double absError = std::fabs(double(fail.outVal) - double(fail.refVal));
+                    const double relError = fail.refVal != 0 ? absError / std::fabs(double(fail.refVal))
+                                                             : std::numeric_limits< double >::infinity();
+                    std::cout << boost::format("(%3i,%3i,%3i) | %24.12f | %24.12f | %13.6e | %13.6e\n") % fail.i %
+                                     fail.j % fail.k % fail.outVal % fail.refVal % absError % relError;
                 }
+                std::cout << std::endl;
+            };
+            printTable("Largest absolute errors", verif.worst_absolute_failures());
+            printTable("Largest relative errors", verif.worst_relative_failures());
+        }
+
+        template < typename T >
+        void print_statistics(const verification< T > &verif) const noexcept {
+            if (!verifSpec_.fieldname().empty() && verif.output_field().name() != verifSpec_.fieldname())
+                return;
+
+            const error_statistics &stats = verif.statistics();
+
+            std::cout << boost::format("Error statistics of '%s' (%i points compared)\n") %
+                             verif.output_field().name() % stats.num_points();
+            std::cout << boost::format("  %-20s : %.6e") % "max. absolute error" % stats.max_absolute_error();
+            if (stats.has_worst_point())
+                std::cout << boost::format(" at (%i,%i,%i)") % stats.worst_i() % stats.worst_j() % stats.worst_k();
+            std::cout << "\n";
+            std::cout << boost::format("  %-20s : %.6e\n") % "max. relative error" % stats.max_relative_error();
+            std::cout << boost::format("  %-20s : %.6e\n") % "RMS error" % stats.rms_error();
+            std::cout << boost::format("  %-20s : %.6e\n") % "L2 norm" % stats.l2_norm();
+            std::cout << boost::format("  %-20s : %.6e\n") % "Linf norm" % stats.linf_norm();
+
+            // Histograms of the differing entries (only non-empty bins)
+            auto printHistogram = [](const char *title, const error_histogram &histogram) {
+                if (histogram.total() == 0)
+                    return;
+                std::cout << boost::format("  %s\n") % title;
+                for (int bin = 0; bin < error_histogram::num_bins; ++bin)
+                    if (histogram.count(bin) > 0)
+                        std::cout << boost::format("    [%7.0e, %7.0e) : %i\n") %
+                                         (bin == 0 ? 0.0 : error_histogram::lower_bound(bin)) %
+                                         (bin + 1 == error_histogram::num_bins
+                                                 ? std::numeric_limits< double >::infinity()
+                                                 : error_histogram::lower_bound(bin + 1)) %
+                                         histogram.count(bin);
+            };
+            printHistogram("absolute errors |a - b|", stats.absolute_error_histogram());
+            printHistogram("relative errors |a - b| / |b|", stats.relative_error_histogram());
+
+            const auto &mismatchesPerK = stats.mismatches_per_k();
+            if (!mismatchesPerK.empty()) {
+                std::cout << "  mismatches per k-layer\n";
+                for (std::size_t k = 0; k < mismatchesPerK.size(); ++k)
+                    if (mismatchesPerK[k] > 0)
+                        std::cout << boost::format("    k = %3i : %i\n") % k % mismatchesPerK[k];
             }
+            std::cout << std::endl;
+        }
+
+        /**
+         * @brief Mask of the layers [0, kSize) to report (see verification_specification::k_ranges())
+         */
+        std::vector< bool > layer_mask(int kSize) const {
+            std::vector< bool > mask(kSize, !verifSpec_.k_interval_specified());
+            for (const auto &range : verifSpec_.k_ranges())
+                for (int k = std::max(0, range.first); k <= std::min(range.second, kSize - 1); ++k)
+                    mask[k] = true;
+            return mask;
         }
 
       public:
@@ -169,7 +284,15 @@ namespace gt_verification {
          */
         template < typename T >
         void report(const verification< T > &verif) const noexcept {
-            if (verifSpec_.list())
+            if (verifSpec_.statistics())
+                print_statistics(verif);
+
+            if (verifSpec_.worst_failures() > 0)
+                print_worst_failures(verif);
+
+            if (verifSpec_.regions())
+                print_regions(verif);
+            else if (verifSpec_.list())
                 list_failures(verif);
 
             if (verifSpec_.visualize())
@@ -14,7 +14,9 @@
 #include "../core/error.h"
 #include "../core/utility.h"
 #include "../core/logger.h"
+#include "../core/parallel.h"
 #include "verification_specification.h"
+#include <algorithm>
 #include <cstdlib>
 #include <string>
 
@@ -22,6 +24,19 @@ namespace gt_verification {
 
     verification_specification::verification_specification(command_line &cl) {
         parse(cl.has("error") ? cl.as< std::string >("error") : std::string());
+
+        numThreads_ = cl.has("threads") ? cl.as< int >("threads") : 1;
+        if (numThreads_ <= 0)
+            numThreads_ = hardware_threads();
+        VERIFICATION_LOG() << "VerificationSpecification: Using " << numThreads_ << " thread(s)" << logger_action::endl;
+
+        prefetch_ = cl.has("prefetch");
+        streamSlab_ = cl.has("stream") ? std::max(0, cl.as< int >("stream")) : 0;
+        if (prefetch_ && streamSlab_ > 0) {
+            // Streaming bounds the memory, which the shadow buffers of a prefetch would double
+            error::warning("ignoring '--prefetch' as '--stream' is enabled");
+            prefetch_ = false;
+        }
     }
 
     void verification_specification::print_help(char *currentExecutable) noexcept {
@@ -58,10 +73,33 @@ namespace gt_verification {
             "usually refers to a Verification::verify() run, by calling "
             "std::exit(1).");
         printKeyword("visualize", "", "Visualize the layers in ASCII art.");
+        printKeyword("statistics",
+            "",
+            "Print the statistics of the error (maximum absolute and relative error, RMS error, L2 and Linf "
+            "norm of the difference and the position of the worst point).");
+        printKeyword("regions",
+            "",
+            "Report the connected regions of failures (bounding box, number of points and maximum absolute "
+            "error) instead of listing every failure.");
+        printKeyword("worst",
+            "<int>",
+            "Print the <int> failures with the largest absolute error and the <int> failures with the largest "
+            "relative error.");
+        printKeyword("dump",
+            "<MB>",
+            "Write the output field, the reference field and their difference of each failing field to the "
+            "error serializer until <MB> megabytes are written (default: 512). A value of 0 disables writing.");
+        printKeyword("report",
+            "<path>",
+            "Write the statistics and the failures of the failing fields to the file <path> (all failures are "
+            "stored unless 'max-errors' is given).");
+        printKeyword("format",
+            "<jsonl|csv|bin>",
+            "Format of the report: JSON lines (default), CSV or binary records.");
         printKeyword("max-errors",
             "<int>",
             "Only print the first <int> errors (implies the keyword "
-            "'list').");
+            "'list'). Only these errors are stored during the verification.");
         printKeyword("k",
             "<X>-<Y>",
             "Only report failures from the layers in the range [X, Y] where"
@@ -91,9 +129,15 @@ namespace gt_verification {
         list_ = false;
         maxErrorsToList_ = -1;
         visualize_ = false;
+        statistics_ = false;
+        regions_ = false;
+        worstFailures_ = 0;
+        dumpLimit_ = std::size_t(512) << 20;
+        reportPath_.clear();
+        reportFormat_ = report_format::jsonl;
         kIntervalSpecified_ = false;
         stopOnError_ = false;
-        kInterval_.clear();
+        kRanges_.clear();
 
         // 2. Parse string
         if (!errorStr.empty()) {
@@ -118,8 +162,8 @@ namespace gt_verification {
                             throw verification_exception(
                                 "parsing error in '--error': missing argument of keyword '%s'", keywordStr);
                         fieldname_ = valueStr;
-                        VERIFICATION_LOG() << "VerificationReporter: Parsing keyword 'field' as " << fieldname_
-                                           << logger_action::endl;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'field' as " << fieldname_
+                                                 << logger_action::endl;
                     }
                     // list
                     else if (keywordStr == "list") {
@@ -127,8 +171,8 @@ namespace gt_verification {
                             throw verification_exception(
                                 "parsing error in '--error': keyword '%s' cannot have an argument", keywordStr);
                         list_ = true;
-                        VERIFICATION_LOG() << "VerificationReporter: Parsing keyword 'list' as true"
-                                           << logger_action::endl;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'list' as true"
+                                                 << logger_action::endl;
                     }
                     // stop-on-error
                     else if (keywordStr == "stop-on-error") {
@@ -136,8 +180,8 @@ namespace gt_verification {
                             throw verification_exception(
                                 "parsing error in '--error': keyword '%s' cannot have an argument", keywordStr);
                         stopOnError_ = true;
-                        VERIFICATION_LOG() << "VerificationReporter: Parsing keyword 'stop-on-error' as true"
-                                           << logger_action::endl;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'stop-on-error' as true"
+                                                 << logger_action::endl;
                     }
                     // visualize
                     else if (keywordStr == "visualize") {
@@ -145,8 +189,59 @@ namespace gt_verification {
                             throw verification_exception(
                                 "parsing error in '--error': keyword '%s' cannot have an argument", keywordStr);
                         visualize_ = true;
-                        VERIFICATION_LOG() << "VerificationReporter: Parsing keyword 'visualize' as true"
-                                           << logger_action::endl;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'visualize' as true"
+                                                 << logger_action::endl;
+                    }
+                    // statistics
+                    else if (keywordStr == "statistics") {
+                        if (!valueStr.empty())
+                            throw verification_exception(
+                                "parsing error in '--error': keyword '%s' cannot have an argument", keywordStr);
+                        statistics_ = true;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'statistics' as true"
+                                                 << logger_action::endl;
+                    }
+                    // regions
+                    else if (keywordStr == "regions") {
+                        if (!valueStr.empty())
+                            throw verification_exception(
+                                "parsing error in '--error': keyword '%s' cannot have an argument", keywordStr);
+                        regions_ = true;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'regions' as true"
+                                                 << logger_action::endl;
+                    }
+                    // worst
+                    else if (keywordStr == "worst") {
+                        if (valueStr.empty())
+                            throw verification_exception(
+                                "parsing error in '--error': missing argument of keyword '%s'", keywordStr);
+                        worstFailures_ = std::max(0, std::atoi(valueStr.c_str()));
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'worst' as "
+                                                 << worstFailures_ << logger_action::endl;
+                    }
+                    // dump
+                    else if (keywordStr == "dump") {
+                        if (valueStr.empty())
+                            throw verification_exception(
+                                "parsing error in '--error': missing argument of keyword '%s'", keywordStr);
+                        dumpLimit_ = static_cast< std::size_t >(std::max(0, std::atoi(valueStr.c_str()))) << 20;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'dump' as "
+                                                 << (dumpLimit_ >> 20) << " MB" << logger_action::endl;
+                    }
+                    // report
+                    else if (keywordStr == "report") {
+                        if (valueStr.empty())
+                            throw verification_exception(
+                                "parsing error in '--error': missing argument of keyword '%s'", keywordStr);
+                        reportPath_ = valueStr;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'report' as " << reportPath_
+                                                 << logger_action::endl;
+                    }
+                    // format
+                    else if (keywordStr == "format") {
+                        reportFormat_ = failure_report::parse_format(valueStr);
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'format' as " << valueStr
+                                                 << logger_action::endl;
                     }
                     // max-errors
                     else if (keywordStr == "max-errors") {
@@ -154,8 +249,8 @@ namespace gt_verification {
                             throw verification_exception(
                                 "parsing error in '--error': missing argument of keyword '%s'", keywordStr);
                         maxErrorsToList_ = std::atoi(valueStr.c_str());
-                        VERIFICATION_LOG() << "VerificationReporter: Parsing keyword 'max-errors' as "
-                                           << maxErrorsToList_ << logger_action::endl;
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'max-errors' as "
+                                                 << maxErrorsToList_ << logger_action::endl;
                     }
                     //                // atol
                     //                else if (keywordStr == "atol") {
@@ -185,22 +280,16 @@ namespace gt_verification {
 
                         auto posOfDelim = valueStr.find('-', 0);
 
-                        // Add a range (e.g 5-10 will add {5, 6, 7, 8, 9, 10})
-                        if (posOfDelim != std::string::npos) {
-                            int kStart = std::atoi(valueStr.substr(0, posOfDelim).c_str());
-                            int kEnd = std::atoi(valueStr.substr(posOfDelim + 1).c_str());
-                            for (int k = kStart; k <= kEnd; ++k)
-                                kInterval_.push_back(k);
-                        }
-                        // Add a single value
-                        else
-                            kInterval_.push_back(std::atoi(valueStr.c_str()));
-
-                        auto &logStream = VERIFICATION_LOG();
-                        logStream << "VerificationReporter: Parsing keyword 'k' as { ";
-                        for (int k : kInterval_)
-                            logStream << k << " ";
-                        logStream << "} " << logger_action::endl;
+                        // Add a range (e.g 5-10) or a single value
+                        int kStart = std::atoi(valueStr.substr(0, posOfDelim).c_str());
+                        int kEnd = posOfDelim != std::string::npos
+                                       ? std::atoi(valueStr.substr(posOfDelim + 1).c_str())
+                                       : kStart;
+                        if (kStart <= kEnd)
+                            kRanges_.emplace_back(kStart, kEnd);
+
+                        VERIFICATION_LOG_DEBUG() << "VerificationReporter: Parsing keyword 'k' as [" << kStart << ", "
+                                                 << kEnd << "]" << logger_action::endl;
                     } else
                         throw verification_exception("parsing error in '--error': unrecognised keyword '%s'",
                             keywordStr.empty() ? "," : keywordStr);
@@ -216,6 +305,16 @@ namespace gt_verification {
         else if (maxErrorsToList_ < 0 && list_)
             maxErrorsToList_ = std::numeric_limits< int >::max();
 
-        kIntervalSpecified_ = !kInterval_.empty();
+        // Sort the k-ranges and merge overlapping and adjacent ones
+        std::sort(kRanges_.begin(), kRanges_.end());
+        std::vector< std::pair< int, int > > kRanges;
+        for (const auto &range : kRanges_)
+            if (!kRanges.empty() && range.first <= kRanges.back().second + 1)
+                kRanges.back().second = std::max(kRanges.back().second, range.second);
+            else
+                kRanges.push_back(range);
+        kRanges_.swap(kRanges);
+
+        kIntervalSpecified_ = !kRanges_.empty();
     }
 }
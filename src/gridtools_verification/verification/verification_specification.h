@@ -10,10 +10,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 #include <string>
+#include <utility>
 #include "../common.h"
 #include "../core/command_line.h"
+#include "failure_report.h"
 #include "verification.h"
 
 namespace gt_verification {
@@ -59,14 +63,14 @@ namespace gt_verification {
          * @brief Whether to report the failures in the format ([i,j,k] | Actual | Refrence)
          *
          * To control the number of errors being reported maxErrorsToList() and to specify the
-         * layers being reported kInterval().
+         * layers being reported k_ranges().
          *
          * @code
          * ./DycoreUnittest --error=list
          * @endcode
          *
          * @see VerificationSpecification::maxErrorsToList()
-         * @see VerificationSpecification::kInterval()
+         * @see VerificationSpecification::k_ranges()
          */
         bool list() const noexcept { return list_; }
 
@@ -82,20 +86,91 @@ namespace gt_verification {
         /**
          * @brief Visualize the layers in ASCII art.
          *
-         * To control the layers being reported set kInterval().
+         * To control the layers being reported set k_ranges().
          *
          * @code
          * ./DycoreUnittest --error=visualize
          * @endcode
          *
-         * @see VerificationSpecification::kInterval()
+         * @see VerificationSpecification::k_ranges()
          */
         bool visualize() const noexcept { return visualize_; }
 
+        /**
+         * @brief Print the statistics of the error (maximum errors, norms and the worst point)
+         *
+         * @code
+         * ./DycoreUnittest --error=statistics
+         * @endcode
+         *
+         * @see error_statistics
+         */
+        bool statistics() const noexcept { return statistics_; }
+
+        /**
+         * @brief Report the connected regions of failures instead of listing them
+         *
+         * Each region is reported with its bounding box, number of points and maximum absolute error. All
+         * failures are stored during the verification to find the regions.
+         *
+         * @code
+         * ./DycoreUnittest --error=regions
+         * @endcode
+         *
+         * @see find_failure_regions()
+         */
+        bool regions() const noexcept { return regions_; }
+
+        /**
+         * @brief Report the N failures with the largest absolute and the N with the largest relative error
+         *
+         * The failures are tracked in bounded heaps during the verification (see
+         * verification::set_worst_failures()), independently of the stored failures. A value of 0 disables
+         * this (default).
+         *
+         * @code
+         * ./DycoreUnittest --error=worst=10
+         * @endcode
+         */
+        int worst_failures() const noexcept { return worstFailures_; }
+
+        /**
+         * @brief Maximum number of bytes of failing fields written to the error serializer per run
+         *
+         * The output field, the reference field and their difference are written for every failing field
+         * until this limit is reached. The limit is passed in MB, 0 disables writing (default: 512 MB).
+         *
+         * @code
+         * ./DycoreUnittest --error=dump=1024
+         * @endcode
+         *
+         * @see error_writer
+         */
+        std::size_t dump_limit() const noexcept { return dumpLimit_; }
+
+        /**
+         * @brief Path of the machine-readable failure report (empty if no report is written)
+         *
+         * The statistics and the failures of all failing fields are written to this file in the
+         * report_file_format() (see failure_report). All failures are stored for the report unless max-errors
+         * is given.
+         *
+         * @code
+         * ./DycoreUnittest --error=report=failures.jsonl,format=jsonl
+         * @endcode
+         */
+        const std::string &report_path() const noexcept { return reportPath_; }
+
+        /**
+         * @brief Format of the failure report (`jsonl` (default), `csv` or `bin`)
+         */
+        report_format report_file_format() const noexcept { return reportFormat_; }
+
         /**
          * @brief Only list the first N failures
          *
-         * This implies list().
+         * This implies list(). Only the listed failures are stored during the verification (see
+         * max_failures_to_store()).
          *
          * @code
          * ./DycoreUnittest --error=max-errors=512
@@ -112,25 +187,126 @@ namespace gt_verification {
          * seperated by '-' in the range [0, kmax]. If <Y> is omitted then only the layer <X> is being
          * reported. Example: k=5-10 or k=20.
          *
+         * The keyword can be given multiple times. The ranges are stored sorted and merged as inclusive
+         * pairs [X, Y].
+         *
          * @code
          * ./DycoreUnittest --error=k=0-20
          * @endcode
          */
-        const std::vector< int > &k_interval() const noexcept { return kInterval_; }
+        const std::vector< std::pair< int, int > > &k_ranges() const noexcept { return kRanges_; }
+
+        /**
+         * @brief Check whether the layer @c k is contained in one of the k_ranges()
+         */
+        bool in_k_interval(int k) const noexcept {
+            auto it = std::upper_bound(kRanges_.begin(),
+                kRanges_.end(),
+                k,
+                [](int k, const std::pair< int, int > &range) { return k < range.first; });
+            return it != kRanges_.begin() && k <= (it - 1)->second;
+        }
+
+        /**
+         * @brief Layers contained in the k_ranges() in ascending order
+         *
+         * @deprecated Expands all ranges, use k_ranges() or in_k_interval() instead
+         */
+        [[gnu::deprecated("use k_ranges() or in_k_interval()")]] std::vector< int > k_interval() const {
+            std::vector< int > layers;
+            for (const auto &range : kRanges_)
+                for (int k = range.first; k <= range.second; ++k)
+                    layers.push_back(k);
+            return layers;
+        }
 
         /**
          * @brief Check whether a k interval was specified
          */
         bool k_interval_specified() const noexcept { return kIntervalSpecified_; }
 
+        /**
+         * @brief Maximum number of failures of the field @c fieldname which need to be stored for reporting
+         *
+         * Failures are only stored if they are going to be reported: all of them if they are visualized or
+         * filtered by k-layers, the first max_errors_to_list() if they are listed and none otherwise (the
+         * failures are only counted then). A negative value means all failures are stored.
+         *
+         * @note Unlike verification::set_max_failures(), which stores all failures by default, no failure is
+         * stored if no `--error` keyword reports them. Code reading verification::failures() of a field_collection
+         * needs to request the failures, e.g. with `--error=list`.
+         *
+         * @see verification::set_max_failures()
+         */
+        int max_failures_to_store(const std::string &fieldname) const noexcept {
+            if (!fieldname_.empty() && fieldname != fieldname_)
+                return 0;
+            if (visualize_ || regions_ || (list_ && kIntervalSpecified_))
+                return -1;
+            if (!reportPath_.empty())
+                return list_ ? maxErrorsToList_ : -1;
+            return list_ ? maxErrorsToList_ : 0;
+        }
+
+        /**
+         * @brief Number of threads used to load the fields of an iteration and to verify a field
+         *
+         * This is not part of the `--error` keywords but set via `--threads=N` or the environment variable
+         * `VERIFICATION_THREADS`. A value of 0 uses all hardware threads, the default is 1.
+         *
+         * @code
+         * ./DycoreUnittest --threads=16
+         * @endcode
+         */
+        int num_threads() const noexcept { return numThreads_; }
+
+        /**
+         * @brief Load the next iteration on a background thread while the current one is verified
+         *
+         * This is not part of the `--error` keywords but set via `--prefetch`. It doubles the memory held by
+         * the input and reference fields of a field_collection. Prefetching is disabled if streaming is enabled (see
+         * stream_slab()).
+         *
+         * @code
+         * ./DycoreUnittest --prefetch
+         * @endcode
+         */
+        bool prefetch() const noexcept { return prefetch_; }
+
+        /**
+         * @brief Number of k-layers of a reference field verified at once while streaming it from the archive
+         *
+         * This is not part of the `--error` keywords but set via `--stream=K`. Reference fields of a Binary
+         * archive are then verified in slabs of K layers directly from the mapped archive and the memory of a
+         * slab is released once it has been verified (see field_collection::verify()). Hence, at most one
+         * slab per field is held in memory. A value of 0 disables streaming (default). Streaming takes precedence over
+         * `--prefetch`, which is then ignored.
+         *
+         * @code
+         * ./DycoreUnittest --stream=8
+         * @endcode
+         */
+        int stream_slab() const noexcept { return streamSlab_; }
+
       private:
         // Parsed options
-        std::string fieldname_;        ///< Keyword: field
-        bool list_;                    ///< Keyword: list
-        bool stopOnError_;             ///< Keyword: stop-on-error
-        bool visualize_;               ///< Keyword: visualize
-        int maxErrorsToList_;          ///< Keyword: max-errors
-        std::vector< int > kInterval_; ///< Keyword: k
+        std::string fieldname_;                        ///< Keyword: field
+        bool list_;                                    ///< Keyword: list
+        bool stopOnError_;                             ///< Keyword: stop-on-error
+        bool visualize_;                               ///< Keyword: visualize
+        bool statistics_;                              ///< Keyword: statistics
+        bool regions_;                                 ///< Keyword: regions
+        int worstFailures_;                            ///< Keyword: worst
+        std::size_t dumpLimit_;                        ///< Keyword: dump
+        std::string reportPath_;                       ///< Keyword: report
+        report_format reportFormat_;                   ///< Keyword: format
+        int maxErrorsToList_;                          ///< Keyword: max-errors
+        std::vector< std::pair< int, int > > kRanges_; ///< Keyword: k
+
+        // Other command-line options
+        int numThreads_; ///< Option: threads
+        bool prefetch_;  ///< Option: prefetch
+        int streamSlab_; ///< Option: stream
 
         // Derived options
         bool kIntervalSpecified_;
@@ -0,0 +1,116 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/error_writer.h>
+#include <string>
+#include <vector>
+
+using namespace gt_verification;
+
+namespace {
+    type_erased_field< double > make_field(const std::string &name, double value) {
+        std::shared_ptr< double > data(new double[4 * 3 * 2], std::default_delete< double[] >());
+        std::fill(data.get(), data.get() + 4 * 3 * 2, value);
+        return type_erased_field< double >(data, name, {{4, 3, 2}}, {{1, 4, 12}});
+    }
+} // namespace
+
+TEST(test_ErrorWriter, WritesLazilyAndRespectsLimit) {
+    int numOpened = 0;
+    const std::size_t fieldBytes = 4 * 3 * 2 * sizeof(double);
+    {
+        error_writer writer(
+            [&]() {
+                ++numOpened;
+                return std::make_shared< ser::serializer >(ser::open_mode::Write, ".", "ErrorWriter");
+            },
+            3 * fieldBytes);
+
+        // Nothing is opened until the first failure is written
+        writer.flush();
+        ASSERT_EQ(numOpened, 0);
+
+        auto output = make_field("output", 3);
+        auto reference = make_field("reference", 1);
+        ser::savepoint savepoint("ErrorWriter-out");
+        ASSERT_TRUE(writer.write_failure("u", output.to_view(), reference.to_view(), savepoint));
+
+        // The fields are copied when they are queued
+        output(0, 0, 0) = 100;
+
+        // The second failure exceeds the limit
+        ASSERT_FALSE(writer.write_failure("v", output.to_view(), reference.to_view(), savepoint));
+        ASSERT_EQ(writer.bytes(), 3 * fieldBytes);
+
+        writer.flush();
+        ASSERT_EQ(numOpened, 1);
+
+        auto serializer = writer.serializer();
+        std::vector< double > diff(4 * 3 * 2);
+        serializer->read("u_diff", savepoint, diff.data(), {1, 4, 12});
+        ASSERT_DOUBLE_EQ(diff[0], 2);
+        ASSERT_DOUBLE_EQ(diff.back(), 2);
+    }
+
+    for (const char *file : {"MetaData-ErrorWriter.json",
+             "ArchiveMetaData-ErrorWriter.json",
+             "ErrorWriter_u_out.dat",
+             "ErrorWriter_u_ref.dat",
+             "ErrorWriter_u_diff.dat"})
+        std::remove(file);
+}
+
+TEST(test_ErrorWriter, LoadWhileWriting) {
+    ser::savepoint savepoint("ErrorWriter-out");
+    auto reference = make_field("u", 1);
+    serialization(std::make_shared< ser::serializer >(ser::open_mode::Write, ".", "ErrorWriterReference"))
+        .write("u", reference.to_view(), savepoint);
+    {
+        auto referenceSerializer =
+            std::make_shared< ser::serializer >(ser::open_mode::Read, ".", "ErrorWriterReference");
+        auto errorSerializer = std::make_shared< ser::serializer >(ser::open_mode::Write, ".", "ErrorWriterErrors");
+        error_writer writer(errorSerializer, 1 << 20);
+
+        // The background write waits as long as the error serializer is locked
+        serialization errorSerialization(errorSerializer);
+        auto lock = errorSerialization.lock();
+        auto output = make_field("output", 3);
+        ASSERT_TRUE(writer.write_failure("u", output.to_view(), reference.to_view(), savepoint));
+
+        // Loading from the reference serializer does not wait for the write
+        auto loaded = make_field("u", 0);
+        auto load = std::async(std::launch::async,
+            [&] { serialization(referenceSerializer).load("u", loaded.to_view(), savepoint); });
+        const bool loadedWhileWriting = load.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+        lock.unlock();
+        ASSERT_TRUE(loadedWhileWriting);
+        load.get();
+        ASSERT_DOUBLE_EQ(loaded(3, 2, 1), 1);
+
+        writer.flush();
+        std::vector< double > diff(4 * 3 * 2);
+        errorSerializer->read("u_diff", savepoint, diff.data(), {1, 4, 12});
+        ASSERT_DOUBLE_EQ(diff[0], 2);
+    }
+
+    for (const char *file : {"MetaData-ErrorWriterReference.json",
+             "ArchiveMetaData-ErrorWriterReference.json",
+             "ErrorWriterReference_u.dat",
+             "MetaData-ErrorWriterErrors.json",
+             "ArchiveMetaData-ErrorWriterErrors.json",
+             "ErrorWriterErrors_u_out.dat",
+             "ErrorWriterErrors_u_ref.dat",
+             "ErrorWriterErrors_u_diff.dat"})
+        std::remove(file);
+}
@@ -0,0 +1,120 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/log_ring_buffer.h>
+#include <gridtools_verification/core/logger.h>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gt_verification;
+
+TEST(test_LogRingBuffer, PushAndPopWrapAround) {
+    log_ring_buffer buffer(64);
+    ASSERT_EQ(buffer.capacity(), 64);
+    ASSERT_TRUE(buffer.empty());
+
+    // Each message takes 4 + 20 bytes, hence the third one wraps around the end of the buffer
+    std::string message;
+    for (int n = 0; n < 10; ++n) {
+        const std::string first(20, char('a' + n)), second(20, char('A' + n));
+        ASSERT_TRUE(buffer.push(first.data(), first.size()));
+        ASSERT_TRUE(buffer.push(second.data(), second.size()));
+        ASSERT_TRUE(buffer.pop(message));
+        ASSERT_EQ(message, first);
+        ASSERT_TRUE(buffer.pop(message));
+        ASSERT_EQ(message, second);
+        ASSERT_FALSE(buffer.pop(message));
+    }
+}
+
+TEST(test_LogRingBuffer, FullBufferRejectsMessage) {
+    log_ring_buffer buffer(64);
+    const std::string message(28, 'x');
+    ASSERT_TRUE(buffer.push(message.data(), message.size()));
+    ASSERT_TRUE(buffer.push(message.data(), message.size()));
+    ASSERT_FALSE(buffer.push("y", 1));
+
+    std::string popped;
+    ASSERT_TRUE(buffer.pop(popped));
+    ASSERT_TRUE(buffer.push("y", 1));
+}
+
+TEST(test_Logger, ThreadsLogToFile) {
+    const std::string path = "Logger.out";
+    logger &log = logger::getInstance();
+    log.set_sink(path);
+    log.enable();
+
+    const int numThreads = 4, numMessages = 100;
+    std::vector< std::thread > threads;
+    for (int t = 0; t < numThreads; ++t)
+        threads.emplace_back([=] {
+            for (int n = 0; n < numMessages; ++n)
+                VERIFICATION_LOG() << "thread " << t << " message " << n << logger_action::endl;
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    log.sync();
+    log.disable();
+    log.set_sink("");
+
+    // Every line is tagged with a timestamp ([HH:MM:SS.mmm) and the id of its thread
+    std::ifstream file(path);
+    std::set< std::string > messages;
+    for (std::string line; std::getline(file, line);) {
+        ASSERT_GT(line.size(), 13);
+        ASSERT_EQ(line[0], '[');
+        ASSERT_EQ(line[3], ':');
+        ASSERT_EQ(line[6], ':');
+        ASSERT_EQ(line[9], '.');
+        for (int n : {1, 2, 4, 5, 7, 8, 10, 11, 12})
+            ASSERT_TRUE(std::isdigit(line[n])) << line;
+        const auto tag = line.find(" T");
+        const auto end = line.find("] ");
+        ASSERT_TRUE(tag != std::string::npos && end != std::string::npos && tag < end) << line;
+        messages.insert(line.substr(end + 2));
+    }
+    std::remove(path.c_str());
+
+    ASSERT_EQ(log.num_dropped(), 0);
+    ASSERT_EQ(messages.size(), numThreads * numMessages);
+    ASSERT_EQ(messages.count("thread 3 message 99"), 1);
+}
+
+TEST(test_Logger, DisabledLogDoesNotEvaluateArguments) {
+    logger::getInstance().disable();
+
+    int evaluated = 0;
+    auto evaluate = [&] { return ++evaluated; };
+    VERIFICATION_LOG_INFO() << "value " << evaluate() << logger_action::endl;
+    VERIFICATION_LOG_DEBUG() << evaluate() << logger_action::endl;
+
+    // The macro is a single expression, hence an else binds to the enclosing if
+    if (evaluated != 0)
+        VERIFICATION_LOG_INFO() << evaluate();
+    else
+        ++evaluated;
+    ASSERT_EQ(evaluated, 1);
+}
+
+TEST(test_Logger, LogIsTheLogger) {
+    logger::getInstance().disable();
+
+    logger &log = VERIFICATION_LOG();
+    log << "value " << 1 << logger_action::endl;
+    ASSERT_EQ(&log, &logger::getInstance());
+}
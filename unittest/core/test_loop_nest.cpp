@@ -0,0 +1,60 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/loop_nest.h>
+#include <vector>
+
+using namespace gt_verification;
+
+TEST(test_LoopNest, OrderFollowsStrides) {
+    // i-fastest layout (e.g. CUDA)
+    loop_nest iFastest(1, 16, 256);
+    ASSERT_TRUE(iFastest.is_canonical());
+
+    // k-fastest layout (e.g. x86)
+    loop_nest kFastest(256, 16, 1);
+    ASSERT_FALSE(kFastest.is_canonical());
+    ASSERT_EQ(kFastest.outer(), 0);
+    ASSERT_EQ(kFastest.middle(), 1);
+    ASSERT_EQ(kFastest.inner(), 2);
+
+    // Equal strides keep the canonical order
+    loop_nest equal(4, 4, 4);
+    ASSERT_TRUE(equal.is_canonical());
+}
+
+TEST(test_LoopNest, ForEachRowVisitsEveryPointOnce) {
+    const std::array< int, 3 > begin{{1, 0, 2}};
+    const std::array< int, 3 > end{{20, 7, 13}};
+
+    for (int tileSize : {0, 1, 4, 64}) {
+        std::vector< int > visits(20 * 7 * 13, 0);
+        loop_nest nest(256, 16, 1);
+
+        for_each_row(begin,
+            end,
+            nest,
+            [&](const std::array< int, 3 > &start, int n) {
+                ASSERT_EQ(start[2], begin[2]);
+                ASSERT_EQ(n, end[2] - begin[2]);
+                for (int k = start[2]; k < start[2] + n; ++k)
+                    ++visits[(start[0] * 7 + start[1]) * 13 + k];
+            },
+            tileSize);
+
+        for (int i = 0; i < 20; ++i)
+            for (int j = 0; j < 7; ++j)
+                for (int k = 0; k < 13; ++k) {
+                    const bool inside = i >= begin[0] && j >= begin[1] && k >= begin[2];
+                    ASSERT_EQ(visits[(i * 7 + j) * 13 + k], inside ? 1 : 0);
+                }
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/mapped_binary_archive.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace gt_verification;
+
+namespace {
+    /**
+     * Archive with the field "u" of 4 doubles stored at the savepoints 0 and 2
+     */
+    class test_MappedBinaryArchive : public ::testing::Test {
+      protected:
+        test_MappedBinaryArchive() {
+            std::ofstream("MetaData-MappedArchive.json")
+                << R"({"archive_name": "Binary", "savepoint_vector": {"fields_per_savepoint": [{"u": 0}, {}, {"u": 1}]}})";
+            std::ofstream("ArchiveMetaData-MappedArchive.json")
+                << R"({"fields_table": {"u": [[0, "a"], [32, "b"]]}})";
+
+            std::vector< double > data{0, 1, 2, 3, 10, 11, 12, 13};
+            std::ofstream("MappedArchive_u.dat", std::ios::binary)
+                .write(reinterpret_cast< const char * >(data.data()), data.size() * sizeof(double));
+        }
+
+        ~test_MappedBinaryArchive() {
+            std::remove("MetaData-MappedArchive.json");
+            std::remove("ArchiveMetaData-MappedArchive.json");
+            std::remove("MappedArchive_u.dat");
+        }
+    };
+} // namespace
+
+TEST_F(test_MappedBinaryArchive, data) {
+    auto archive = mapped_binary_archive::open(".", "MappedArchive");
+    ASSERT_TRUE(archive != nullptr);
+
+    auto first = archive->data("u", 0, 4 * sizeof(double));
+    ASSERT_TRUE(first != nullptr);
+    ASSERT_DOUBLE_EQ(reinterpret_cast< const double * >(first.get())[3], 3);
+
+    auto second = archive->data("u", 2, 4 * sizeof(double));
+    ASSERT_TRUE(second != nullptr);
+    ASSERT_DOUBLE_EQ(reinterpret_cast< const double * >(second.get())[0], 10);
+
+    // Not stored at the savepoint, unknown field and out of bounds
+    ASSERT_TRUE(archive->data("u", 1, 4 * sizeof(double)) == nullptr);
+    ASSERT_TRUE(archive->data("v", 0, 4 * sizeof(double)) == nullptr);
+    ASSERT_TRUE(archive->data("u", 2, 5 * sizeof(double)) == nullptr);
+
+    // The mapping outlives the archive
+    archive.reset();
+    ASSERT_DOUBLE_EQ(reinterpret_cast< const double * >(second.get())[3], 13);
+}
+
+TEST_F(test_MappedBinaryArchive, release) {
+    auto archive = mapped_binary_archive::open(".", "MappedArchive");
+    ASSERT_TRUE(archive != nullptr);
+
+    // Released pages are read again from the file
+    auto field = archive->data("u", 2, 4 * sizeof(double));
+    ASSERT_TRUE(field != nullptr);
+    mapped_binary_archive::release(field.get(), 4 * sizeof(double));
+    ASSERT_DOUBLE_EQ(reinterpret_cast< const double * >(field.get())[1], 11);
+}
+
+TEST_F(test_MappedBinaryArchive, release_only_whole_pages) {
+    auto archive = mapped_binary_archive::open(".", "MappedArchive");
+    ASSERT_TRUE(archive != nullptr);
+
+    // The mapping is private, hence the modification is kept until its page is released
+    auto field = archive->data("u", 0, 4 * sizeof(double));
+    ASSERT_TRUE(field != nullptr);
+    double *data = reinterpret_cast< double * >(const_cast< char * >(field.get()));
+    data[3] = 42;
+
+    // A range inside a page does not release it
+    mapped_binary_archive::release(data, 2 * sizeof(double));
+    ASSERT_DOUBLE_EQ(data[3], 42);
+
+    // The field starts at the beginning of the mapping, i.e. of a page
+    const std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    mapped_binary_archive::release(data, pageSize);
+    ASSERT_DOUBLE_EQ(data[3], 3);
+}
+
+TEST_F(test_MappedBinaryArchive, not_binary) {
+    std::ofstream("MetaData-MappedArchive.json") << R"({"archive_name": "NetCDF"})";
+    ASSERT_TRUE(mapped_binary_archive::open(".", "MappedArchive") == nullptr);
+    ASSERT_TRUE(mapped_binary_archive::open(".", "NoSuchArchive") == nullptr);
+}
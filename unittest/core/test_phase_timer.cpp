@@ -0,0 +1,99 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/phase_timer.h>
+#include <string>
+#include <thread>
+
+using namespace gt_verification;
+
+namespace {
+    class test_PhaseTimer : public ::testing::Test {
+      protected:
+        test_PhaseTimer() : statistics(phase_statistics::get_instance()), enabled(statistics.enabled()) {
+            statistics.clear();
+            statistics.set_scope_function([this]() { return scope; });
+        }
+
+        ~test_PhaseTimer() {
+            statistics.clear();
+            statistics.set_scope_function(nullptr);
+            statistics.enable(enabled);
+        }
+
+        phase_statistics &statistics;
+        bool enabled;
+        std::string scope = "first";
+    };
+} // namespace
+
+TEST_F(test_PhaseTimer, DisabledTimerIsNotRecorded) {
+    statistics.enable(false);
+    {
+        phase_timer timer("load", 100);
+        ASSERT_EQ(timer.seconds(), 0);
+    }
+    ASSERT_TRUE(statistics.scopes().empty());
+}
+
+TEST_F(test_PhaseTimer, PhasesAreAccumulatedPerScope) {
+    statistics.enable();
+    {
+        phase_timer timer("load", 1000);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    {
+        phase_timer timer("verify");
+        timer.add_bytes(500);
+    }
+    {
+        phase_timer timer("load", 2000);
+    }
+    scope = "second";
+    {
+        phase_timer timer("verify", 10);
+    }
+
+    ASSERT_EQ(statistics.scopes(), (std::vector< std::string >{"first", "second"}));
+
+    auto phases = statistics.phases("first");
+    ASSERT_EQ(phases.size(), 2);
+    ASSERT_EQ(phases[0].name, "load");
+    ASSERT_EQ(phases[0].count, 2);
+    ASSERT_EQ(phases[0].bytes, 3000);
+    ASSERT_GE(phases[0].seconds, 0.01);
+    ASSERT_GT(phases[0].gigabytes_per_second(), 0);
+    ASSERT_EQ(phases[1].name, "verify");
+    ASSERT_EQ(phases[1].bytes, 500);
+
+    phases = statistics.phases("second");
+    ASSERT_EQ(phases.size(), 1);
+    ASSERT_EQ(phases[0].bytes, 10);
+    ASSERT_TRUE(statistics.phases("third").empty());
+}
+
+TEST_F(test_PhaseTimer, WriteCsv) {
+    statistics.enable();
+    statistics.add("test", "load", 0.5, 1000000000);
+
+    statistics.write_csv("PhaseTimer.csv");
+    std::ifstream file("PhaseTimer.csv");
+    std::string header, row;
+    std::getline(file, header);
+    std::getline(file, row);
+    std::remove("PhaseTimer.csv");
+
+    ASSERT_EQ(header, "scope,phase,count,seconds,bytes,gb_per_s");
+    ASSERT_EQ(row, "test,load,1,0.5,1000000000,2");
+}
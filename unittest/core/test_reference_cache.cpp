@@ -0,0 +1,85 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/reference_cache.h>
+#include <thread>
+#include <vector>
+
+using namespace gt_verification;
+
+namespace {
+    std::shared_ptr< char > make_buffer(std::size_t bytes) {
+        return std::shared_ptr< char >(new char[bytes], std::default_delete< char[] >());
+    }
+} // namespace
+
+TEST(test_ReferenceCache, LeastRecentlyUsedIsEvicted) {
+    reference_cache &cache = reference_cache::get_instance();
+    const std::size_t budget = cache.budget();
+    cache.clear();
+    cache.set_budget(300);
+
+    cache.insert("a", make_buffer(100), 100);
+    cache.insert("b", make_buffer(100), 100);
+    cache.insert("c", make_buffer(100), 100);
+    ASSERT_EQ(cache.size(), 300);
+
+    // "a" is now the most recently used entry, hence "b" is evicted
+    auto a = cache.find("a");
+    ASSERT_TRUE(a != nullptr);
+    cache.insert("d", make_buffer(100), 100);
+    ASSERT_TRUE(cache.find("b") == nullptr);
+    ASSERT_TRUE(cache.find("a") != nullptr);
+    ASSERT_TRUE(cache.find("d") != nullptr);
+    ASSERT_EQ(cache.size(), 300);
+
+    // Buffers larger than the budget are not stored
+    cache.insert("e", make_buffer(400), 400);
+    ASSERT_TRUE(cache.find("e") == nullptr);
+
+    // Handed out buffers outlive their eviction
+    cache.set_budget(0);
+    ASSERT_FALSE(cache.enabled());
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_TRUE(cache.find("a") == nullptr);
+    a.get()[99] = 1;
+
+    cache.set_budget(budget);
+}
+
+TEST(test_ReferenceCache, ConcurrentAccess) {
+    reference_cache &cache = reference_cache::get_instance();
+    const std::size_t budget = cache.budget();
+    cache.clear();
+    cache.set_budget(1000);
+    const std::size_t hits = cache.hits(), misses = cache.misses();
+
+    // The counters and the budget are read while other threads modify the cache
+    std::vector< std::thread > threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&cache, t] {
+            const std::string key = "key" + std::to_string(t);
+            for (int n = 0; n < 1000; ++n) {
+                if (!cache.find(key))
+                    cache.insert(key, make_buffer(100), 100);
+                if (cache.enabled())
+                    ASSERT_LE(cache.size(), cache.budget());
+            }
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_EQ(cache.hits() + cache.misses() - hits - misses, 4000);
+    ASSERT_EQ(cache.misses() - misses, 4);
+
+    cache.clear();
+    cache.set_budget(budget);
+}
@@ -0,0 +1,48 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/savepoint_index.h>
+#include <memory>
+
+using namespace gt_verification;
+
+TEST(test_SavepointIndex, pairs) {
+    std::unique_ptr< savepoint_index > indexPtr;
+    {
+        ser::serializer serializer(ser::open_mode::Write, ".", "SavepointIndex");
+        // Savepoints with the same name are told apart by their meta-information
+        int id = 0;
+        for (const char *name : {"a-out", "a-in", "other", "a-out-other", "a-out", "b-in", "b-out"}) {
+            ser::savepoint savepoint(name);
+            savepoint.add_meta_info("id", id++);
+            serializer.register_savepoint(savepoint);
+        }
+        indexPtr.reset(new savepoint_index(serializer));
+    }
+    std::remove("MetaData-SavepointIndex.json");
+
+    savepoint_index &index = *indexPtr;
+    ASSERT_EQ(index.size(), 7);
+    ASSERT_EQ(index.positions("a-out"), (std::vector< int >{0, 4}));
+    ASSERT_TRUE(index.positions("c-in").empty());
+
+    // The first "a-out" has no preceding input savepoint
+    const auto &a = index.pairs("a-in", "a-out");
+    ASSERT_EQ(a.size(), 1);
+    ASSERT_EQ(a[0], std::make_pair(1, 4));
+    ASSERT_EQ(index.savepoint(a[0].second).name(), "a-out");
+
+    // Pairs are computed once
+    ASSERT_EQ(&index.pairs("a-in", "a-out"), &a);
+    ASSERT_EQ(index.pairs("b-in", "b-out").size(), 1);
+    ASSERT_TRUE(index.pairs("c-in", "c-out").empty());
+}
@@ -0,0 +1,59 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/parallel.h>
+#include <gridtools_verification/core/thread_pool.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace gt_verification;
+
+TEST(test_ThreadPool, EveryBlockIsProcessedOnce) {
+    std::vector< std::atomic< int > > counts(8);
+    for (auto &count : counts)
+        count = 0;
+    thread_pool::get_instance().run(counts.size(), [&](int block) { ++counts[block]; });
+    for (auto &count : counts)
+        ASSERT_EQ(count, 1);
+}
+
+TEST(test_ThreadPool, WorkersAreReused) {
+    thread_pool &pool = thread_pool::get_instance();
+    pool.run(4, [](int) {});
+    const int numWorkers = pool.num_workers();
+    ASSERT_GE(numWorkers, 1);
+
+    for (int n = 0; n < 10; ++n)
+        pool.run(4, [](int) {});
+    ASSERT_EQ(pool.num_workers(), numWorkers);
+}
+
+TEST(test_ThreadPool, NestedRunsComplete) {
+    // All workers are busy with the outer blocks, hence the inner blocks are processed by their callers
+    std::atomic< int > count(0);
+    parallel_for_blocks(0, 4, 4, [&](int, int, int) {
+        parallel_for_blocks(0, 4, 4, [&](int, int begin, int end) { count += end - begin; });
+    });
+    ASSERT_EQ(count, 16);
+}
+
+TEST(test_ThreadPool, ExceptionIsRethrown) {
+    std::atomic< int > count(0);
+    ASSERT_THROW(parallel_for_blocks(0, 100, 4,
+                     [&](int block, int begin, int end) {
+                         count += end - begin;
+                         if (block == 2)
+                             throw std::runtime_error("block 2");
+                     }),
+        std::runtime_error);
+    ASSERT_EQ(count, 100);
+}
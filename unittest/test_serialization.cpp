@@ -13,6 +13,7 @@
 #include <cmath>
 #include <gridtools/common/defs.hpp>
 #include <gridtools_verification/core.h>
+#include <gridtools_verification/core/parallel.h>
 #include <gridtools_verification/core/serialization.h>
 
 #include <gtest/gtest.h>
@@ -160,4 +161,39 @@ TEST_F(SerializationUnittest, FortranToGridTools) {
                 ASSERT_DOUBLE_EQ(view(i, j, k), fortranField[k * jSize * iSize + j * iSize + i]);
 }
 
+/**
+ * Load several fields concurrently
+ */
+TEST_F(SerializationUnittest, ConcurrentLoad) {
+    const int numFields = 8;
+    IJKStorageInfoType metaData(iSize, jSize, kSize);
+
+    IJKRealField gridToolsField(metaData, -1, "GridToolsField");
+    fillUniqueValues(gridToolsField);
+
+    for (int n = 0; n < numFields; ++n) {
+        const std::string name = "ConcurrentField" + std::to_string(n);
+        serialization_->write(name, gridToolsField, savepoint_);
+        files_.push_back("SerializationUnittest_" + name + ".dat");
+    }
+
+    std::vector< IJKRealField > loadedFields;
+    for (int n = 0; n < numFields; ++n)
+        loadedFields.emplace_back(metaData, -1, "LoadedField" + std::to_string(n));
+
+    parallel_for_blocks(0, numFields, numFields, [&](int, int nBegin, int nEnd) {
+        for (int n = nBegin; n < nEnd; ++n)
+            serialization_->load("ConcurrentField" + std::to_string(n), loadedFields[n], savepoint_);
+    });
+
+    auto view = make_host_view(gridToolsField);
+    for (auto &loadedField : loadedFields) {
+        auto loadedView = make_host_view(loadedField);
+        for (int i = 0; i < iSize; ++i)
+            for (int j = 0; j < jSize; ++j)
+                for (int k = 0; k < kSize; ++k)
+                    ASSERT_DOUBLE_EQ(loadedView(i, j, k), view(i, j, k));
+    }
+}
+
 #endif
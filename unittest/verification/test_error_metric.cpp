@@ -9,10 +9,91 @@
  */
 
 #include <gmock/gmock.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
 #include <gridtools_verification/verification/error_metric.h>
+#include <vector>
 
 TEST(error_metric, clear_separation) {
     gt_verification::error_metric< float > em1(1.e-6, 1e-8);
     ASSERT_TRUE(em1.equal(1.0, 1.0));
     ASSERT_FALSE(em1.equal(1.0, 2.0));
 }
+
+TEST(error_metric, equal_n_matches_equal) {
+    gt_verification::error_metric< double > em(1.e-6, 1e-8);
+
+    // Odd size to also cover the remainder of vectorized loops
+    const int n = 37;
+    std::vector< double > a(n, 1.0), b(n, 1.0);
+    a[0] = 2.0;
+    a[17] = 1.0 + 1e-3;
+    a[n - 1] = std::nan("");
+    b[20] = std::nan("");
+
+    bool mask[n];
+    ASSERT_EQ(em.equal_n(a.data(), b.data(), n, mask), 4);
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(mask[i], em.equal(a[i], b[i])) << "i = " << i;
+}
+
+namespace {
+    /**
+     * Compare equal_n() against equal() for pairs whose difference is exactly at the tolerance where the tolerance
+     * atol + rtol * |b| rounds differently if it is contracted into a fused multiply-add
+     */
+    template < typename T >
+    void check_tolerance_boundary(T rtol, T atol) {
+        gt_verification::error_metric< T > em(rtol, atol);
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution< T > distribution(T(0.5), T(4));
+        std::vector< T > a, b;
+        for (int n = 0; n < 10000; ++n) {
+            // Volatile prevents the contraction of the separate tolerance in this test
+            const T ref = distribution(generator) * atol;
+            volatile T product = rtol * std::fabs(ref);
+            volatile T sum = atol + product;
+            const T separate = sum;
+            const T fused = std::fma(rtol, std::fabs(ref), atol);
+            if (separate == fused)
+                continue;
+
+            const T out = ref + std::max(separate, fused);
+            for (T value : {out, std::nextafter(out, T(0)), std::nextafter(out, T(1))}) {
+                a.push_back(value);
+                b.push_back(ref);
+            }
+        }
+        ASSERT_FALSE(a.empty());
+
+        const int size = a.size();
+        std::unique_ptr< bool[] > mask(new bool[size]);
+        em.equal_n(a.data(), b.data(), size, mask.get());
+        for (int i = 0; i < size; ++i)
+            ASSERT_EQ(mask[i], em.equal(a[i], b[i])) << "a = " << a[i] << ", b = " << b[i];
+    }
+} // namespace
+
+TEST(error_metric, equal_n_matches_equal_at_tolerance_boundary) {
+    check_tolerance_boundary< double >(0.1, 1e-8);
+    check_tolerance_boundary< float >(0.1f, 1e-6f);
+}
+
+TEST(error_metric, policies) {
+    gt_verification::absolute_error_metric< double > absolute(1e-3);
+    ASSERT_TRUE(absolute.equal(1000.0, 1000.0005));
+    ASSERT_FALSE(absolute.equal(1000.0, 1000.01));
+
+    gt_verification::relative_error_metric< double > relative(1e-3);
+    ASSERT_TRUE(relative.equal(1000.0, 1000.5));
+    ASSERT_FALSE(relative.equal(0.0, 1e-10));
+
+    gt_verification::exact_error_metric< double > exact;
+    ASSERT_TRUE(exact.equal(1.0, 1.0));
+    ASSERT_TRUE(exact.equal(0.0, -0.0));
+    ASSERT_FALSE(exact.equal(1.0, 1.0 + 1e-15));
+    ASSERT_FALSE(exact.equal(std::nan(""), std::nan("")));
+}
@@ -0,0 +1,66 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <gridtools_verification/verification/failure_regions.h>
+#include <vector>
+
+using namespace gt_verification;
+
+namespace {
+    struct failure {
+        int i, j, k;
+        double outVal, refVal;
+    };
+} // namespace
+
+TEST(test_FailureRegions, Empty) { ASSERT_TRUE(find_failure_regions(std::vector< failure >()).empty()); }
+
+TEST(test_FailureRegions, RectangularPatchesAndIsolatedPoints) {
+    std::vector< failure > failures;
+
+    // Patch of 3 x 2 x 2 points with the worst error at (6, 3, 1)
+    for (int k = 0; k < 2; ++k)
+        for (int j = 2; j < 4; ++j)
+            for (int i = 4; i < 7; ++i)
+                failures.push_back(failure{i, j, k, (i == 6 && j == 3 && k == 1) ? 5.0 : 1.0, 0.0});
+
+    // Two isolated points (diagonal neighbours are not connected)
+    failures.push_back(failure{0, 0, 5, 2, 0});
+    failures.push_back(failure{1, 1, 5, 2, 0});
+
+    // Line of 4 points along k
+    for (int k = 3; k < 7; ++k)
+        failures.push_back(failure{9, 9, k, -1, 0});
+
+    auto regions = find_failure_regions(failures);
+    ASSERT_EQ(regions.size(), 4);
+
+    // Largest region first
+    ASSERT_EQ(regions[0].numPoints, 12);
+    ASSERT_EQ(regions[0].iMin, 4);
+    ASSERT_EQ(regions[0].iMax, 6);
+    ASSERT_EQ(regions[0].jMin, 2);
+    ASSERT_EQ(regions[0].jMax, 3);
+    ASSERT_EQ(regions[0].kMin, 0);
+    ASSERT_EQ(regions[0].kMax, 1);
+    ASSERT_DOUBLE_EQ(regions[0].maxAbsError, 5);
+    ASSERT_EQ(regions[0].worstI, 6);
+    ASSERT_EQ(regions[0].worstJ, 3);
+    ASSERT_EQ(regions[0].worstK, 1);
+
+    ASSERT_EQ(regions[1].numPoints, 4);
+    ASSERT_EQ(regions[1].kMin, 3);
+    ASSERT_EQ(regions[1].kMax, 6);
+    ASSERT_DOUBLE_EQ(regions[1].maxAbsError, 1);
+
+    ASSERT_EQ(regions[2].numPoints, 1);
+    ASSERT_EQ(regions[3].numPoints, 1);
+}
@@ -0,0 +1,132 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <gridtools_verification/verification/failure_report.h>
+#include <gridtools_verification/verification_exception.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace gt_verification;
+
+namespace {
+    type_erased_field< double > make_field(const std::string &name, double value) {
+        std::shared_ptr< double > data(new double[4 * 3 * 2], std::default_delete< double[] >());
+        std::fill(data.get(), data.get() + 4 * 3 * 2, value);
+        return type_erased_field< double >(data, name, {{4, 3, 2}}, {{1, 4, 12}});
+    }
+
+    std::vector< std::string > read_lines(const std::string &path) {
+        std::ifstream file(path);
+        std::vector< std::string > lines;
+        for (std::string line; std::getline(file, line);)
+            lines.push_back(line);
+        return lines;
+    }
+
+    class test_FailureReport : public ::testing::Test {
+      protected:
+        test_FailureReport() : output(make_field("u", 1)), reference(make_field("u_ref", 1)) {
+            output(1, 2, 0) = 3;
+            output(3, 0, 1) = -1;
+        }
+
+        ~test_FailureReport() { std::remove("FailureReport.out"); }
+
+        verification< double > verify() {
+            verification< double > verif(output.to_view(), reference.to_view());
+            verif.verify(error_metric< double >(1e-6, 1e-8));
+            return verif;
+        }
+
+        type_erased_field< double > output;
+        type_erased_field< double > reference;
+    };
+} // namespace
+
+TEST_F(test_FailureReport, jsonl) {
+    {
+        failure_report report("FailureReport.out", report_format::jsonl);
+        report.write("collection", verify());
+    }
+
+    auto lines = read_lines("FailureReport.out");
+    ASSERT_EQ(lines.size(), 3);
+    ASSERT_EQ(lines[0].find("{\"type\":\"field\",\"collection\":\"collection\",\"field\":\"u\",\"points\":24,"
+                            "\"failures\":2,\"stored\":2,\"max_abs_error\":2,"),
+        0);
+    ASSERT_EQ(lines[1],
+        "{\"type\":\"failure\",\"collection\":\"collection\",\"field\":\"u\",\"i\":1,\"j\":2,\"k\":0,\"output\":3,"
+        "\"reference\":1}");
+    ASSERT_EQ(lines[2].find("{\"type\":\"failure\",\"collection\":\"collection\",\"field\":\"u\",\"i\":3,"), 0);
+}
+
+TEST_F(test_FailureReport, jsonl_escapes_strings) {
+    {
+        failure_report report("FailureReport.out", report_format::jsonl);
+        report.write("a\"b\\c\td\ne\x01\x1f", verify());
+    }
+
+    auto lines = read_lines("FailureReport.out");
+    ASSERT_EQ(lines.size(), 3);
+    ASSERT_EQ(lines[0].find("{\"type\":\"field\",\"collection\":\"a\\\"b\\\\c\\td\\ne\\u0001\\u001f\","), 0);
+}
+
+TEST_F(test_FailureReport, csv) {
+    {
+        // A tiny buffer is flushed in between
+        failure_report report("FailureReport.out", report_format::csv, 16);
+        report.write("collection", verify());
+    }
+
+    auto lines = read_lines("FailureReport.out");
+    ASSERT_EQ(lines.size(), 4);
+    ASSERT_EQ(lines[0].find("type,collection,field,i,j,k,output,reference,points,failures,stored,"), 0);
+    ASSERT_EQ(lines[1].find("field,collection,u,,,,,,24,2,2,2,"), 0);
+    ASSERT_EQ(lines[2], "failure,collection,u,1,2,0,3,1,,,,,,,,");
+}
+
+TEST_F(test_FailureReport, binary) {
+    {
+        failure_report report("FailureReport.out", report_format::binary);
+        report.write("c", verify());
+    }
+
+    std::ifstream file("FailureReport.out", std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string data = content.str();
+
+    const std::size_t fieldBytes = 1 + (4 + 1) + (4 + 1) + 3 * 8 + 5 * 8;
+    const std::size_t failureBytes = 3 * 4 + 2 * 8;
+    ASSERT_EQ(data.size(), 8 + fieldBytes + 2 * failureBytes);
+    ASSERT_EQ(data.substr(0, 8), "GTVREP01");
+    ASSERT_EQ(data[8], 'F');
+
+    // First failure
+    std::int32_t i;
+    double outVal;
+    std::memcpy(&i, data.data() + 8 + fieldBytes, sizeof(i));
+    std::memcpy(&outVal, data.data() + 8 + fieldBytes + 3 * 4, sizeof(outVal));
+    ASSERT_EQ(i, 1);
+    ASSERT_DOUBLE_EQ(outVal, 3);
+}
+
+TEST_F(test_FailureReport, parse_format) {
+    ASSERT_EQ(failure_report::parse_format("jsonl"), report_format::jsonl);
+    ASSERT_EQ(failure_report::parse_format("csv"), report_format::csv);
+    ASSERT_EQ(failure_report::parse_format("bin"), report_format::binary);
+    ASSERT_THROW(failure_report::parse_format("xml"), verification_exception);
+}
@@ -0,0 +1,207 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "../helper_dycore.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <gridtools_verification/core/command_line.h>
+#include <gridtools_verification/verification/field_collection.h>
+#include <gridtools_verification/verification/unittest_environment.h>
+#include <string>
+#include <vector>
+
+using namespace gt_verification;
+
+#ifdef HAS_GRIDTOOLS
+
+namespace {
+    ser::savepoint make_savepoint(const std::string &name, int iteration) {
+        ser::savepoint savepoint(name);
+        savepoint.add_meta_info("iteration", iteration);
+        return savepoint;
+    }
+
+    void fill(IJKRealField &field, Real value) {
+        auto view = make_host_view(field);
+        for (int i = 0; i < field.get_storage_info_ptr()->template total_length< 0 >(); ++i)
+            for (int j = 0; j < field.get_storage_info_ptr()->template total_length< 1 >(); ++j)
+                for (int k = 0; k < field.get_storage_info_ptr()->template total_length< 2 >(); ++k)
+                    view(i, j, k) = value;
+    }
+
+    bool all_equal(IJKRealField &field, Real value) {
+        auto view = make_host_view(field);
+        for (int i = 0; i < field.get_storage_info_ptr()->template total_length< 0 >(); ++i)
+            for (int j = 0; j < field.get_storage_info_ptr()->template total_length< 1 >(); ++j)
+                for (int k = 0; k < field.get_storage_info_ptr()->template total_length< 2 >(); ++k)
+                    if (view(i, j, k) != value)
+                        return false;
+        return true;
+    }
+
+    verification_specification make_specification(const char *option) {
+        const char *argv[] = {"test_verification", option};
+        command_line cl(option ? 2 : 1, argv);
+        return verification_specification(cl);
+    }
+
+    std::vector< std::string > read_lines(const std::string &path) {
+        std::ifstream file(path);
+        std::vector< std::string > lines;
+        for (std::string line; std::getline(file, line);)
+            lines.push_back(line);
+        return lines;
+    }
+} // namespace
+
+/**
+ * Reference data of the collection "FieldCollection": at iteration n, the input field "u" is n and the
+ * reference of the output field "v" is 10 * n. The collection "FieldCollectionOther" holds 100 + n and
+ * 100 + 10 * n.
+ */
+class test_FieldCollection : public ::testing::Test {
+  protected:
+    static constexpr int numIterations = 3;
+
+    IJKStorageInfoType metaData;
+    IJKRealField input;
+    IJKRealField output;
+
+    test_FieldCollection() : metaData(6, 5, 4), input(metaData, -1, "u"), output(metaData, -1, "v") {
+        serialization serialization(
+            std::make_shared< ser::serializer >(ser::open_mode::Write, ".", "FieldCollection"));
+        for (int n = 0; n < numIterations; ++n) {
+            fill(input, n);
+            fill(output, 10 * n);
+            serialization.write("u", input, make_savepoint("FieldCollection-in", n));
+            serialization.write("v", output, make_savepoint("FieldCollection-out", n));
+
+            fill(input, 100 + n);
+            fill(output, 100 + 10 * n);
+            serialization.write("u", input, make_savepoint("FieldCollectionOther-in", n));
+            serialization.write("v", output, make_savepoint("FieldCollectionOther-out", n));
+        }
+        fill(input, -1);
+        fill(output, -1);
+    }
+
+    ~test_FieldCollection() {
+        for (const char *file : {"MetaData-FieldCollection.json",
+                 "ArchiveMetaData-FieldCollection.json",
+                 "FieldCollection_u.dat",
+                 "FieldCollection_v.dat",
+                 "FieldCollection.jsonl"})
+            std::remove(file);
+    }
+
+    static std::shared_ptr< ser::serializer > open_reference() {
+        return std::make_shared< ser::serializer >(ser::open_mode::Read, ".", "FieldCollection");
+    }
+
+    field_collection< Real > make_collection(const char *option, const std::string &name = "FieldCollection") {
+        field_collection< Real > collection(make_specification(option), name);
+        collection.attach_reference_serializer(open_reference(), name + "-in", name + "-out");
+        collection.register_input_field("u", input);
+        collection.register_output_and_reference_field("v", output);
+        return collection;
+    }
+
+    /**
+     * Load @c iteration, check the input field and verify the output field against the reference
+     */
+    void check_iteration(field_collection< Real > &collection, int iteration, Real inputValue, Real referenceValue) {
+        collection.load_iteration(iteration);
+        ASSERT_TRUE(all_equal(input, inputValue)) << "iteration " << iteration;
+
+        fill(output, referenceValue);
+        ASSERT_TRUE(collection.verify(error_metric< Real >(1e-6, 1e-8)).passed()) << "iteration " << iteration;
+        fill(output, referenceValue + 1);
+        ASSERT_FALSE(collection.verify(error_metric< Real >(1e-6, 1e-8)).passed()) << "iteration " << iteration;
+    }
+};
+
+TEST_F(test_FieldCollection, ReportContainsCollectionName) {
+    {
+        const char *argv[] = {"test_verification", "--path=.", "--error=report=FieldCollection.jsonl,dump=0"};
+        command_line cl(3, argv);
+        unittest_environment environment(cl, "FieldCollection");
+
+        auto collection = environment.create_field_collection< Real >("FieldCollection");
+        ASSERT_EQ(collection.name(), "FieldCollection");
+        collection.register_input_field("u", input);
+        collection.register_output_and_reference_field("v", output);
+
+        collection.load_iteration(1);
+        ASSERT_FALSE(environment.verify_collection(collection, error_metric< Real >(1e-6, 1e-8)));
+    }
+
+    // The report is complete once the environment and the collection are destroyed
+    auto lines = read_lines("FieldCollection.jsonl");
+    ASSERT_FALSE(lines.empty());
+    for (const auto &line : lines)
+        ASSERT_NE(line.find("\"collection\":\"FieldCollection\",\"field\":\"v\""), std::string::npos) << line;
+}
+
+TEST_F(test_FieldCollection, ParallelLoadsFillAllFields) {
+    IJKRealField second(metaData, -1, "u2");
+    auto collection = make_collection("--threads=4");
+    collection.register_input_field("u", second);
+
+    for (int n = 0; n < numIterations; ++n) {
+        check_iteration(collection, n, n, 10 * n);
+        ASSERT_TRUE(all_equal(second, n)) << "iteration " << n;
+    }
+}
+
+TEST_F(test_FieldCollection, MissingFieldIsReportedOnce) {
+    // The fields are loaded by several threads, one of them fails. The error is only reported after all threads
+    // have finished.
+    IJKRealField missing(metaData, -1, "w");
+    IJKRealField other(metaData, -1, "u2");
+    auto collection = make_collection("--threads=4");
+    collection.register_input_field("w", missing);
+    collection.register_input_field("u", other);
+
+    EXPECT_EXIT(collection.load_iteration(0),
+        ::testing::ExitedWithCode(EXIT_FAILURE),
+        "error: failed to load 1 field\\(s\\) of iteration '0':\n - w: [^\n]*\n$");
+}
+
+TEST_F(test_FieldCollection, PrefetchLoadsEachIteration) {
+    auto collection = make_collection("--prefetch");
+    ASSERT_EQ(collection.iterations().size(), std::size_t(numIterations));
+    for (int n = 0; n < numIterations; ++n)
+        check_iteration(collection, n, n, 10 * n);
+
+    // Loading an iteration again after the last one
+    check_iteration(collection, 0, 0, 0);
+}
+
+TEST_F(test_FieldCollection, PrefetchIsDiscardedWhenSkippingIterations) {
+    auto collection = make_collection("--prefetch");
+
+    // Iteration 1 is prefetched but 2 is requested
+    check_iteration(collection, 0, 0, 0);
+    check_iteration(collection, 2, 2, 20);
+    check_iteration(collection, 1, 1, 10);
+}
+
+TEST_F(test_FieldCollection, PrefetchIsDiscardedWhenAttachingSerializer) {
+    auto collection = make_collection("--prefetch");
+
+    // Iteration 1 of "FieldCollection" is prefetched, but the iterations of "FieldCollectionOther" are loaded
+    check_iteration(collection, 0, 0, 0);
+    collection.attach_reference_serializer(open_reference(), "FieldCollectionOther-in", "FieldCollectionOther-out");
+    check_iteration(collection, 1, 101, 110);
+    check_iteration(collection, 2, 102, 120);
+}
+
+#endif
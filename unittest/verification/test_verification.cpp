@@ -11,6 +11,7 @@
 // TODO recover test without dycore dependency
 
 #include "../helper_dycore.h"
+#include <cmath>
 #include <gmock/gmock.h>
 #include <gridtools_verification/verification/field_collection.h>
 #include <gridtools_verification/verification/verification.h>
@@ -50,6 +51,46 @@ TEST_F(test_Verification, UnmodifiedFieldShouldPass) {
     ASSERT_TRUE(test.verify(errorMetric).passed());
 }
 
+TEST_F(test_Verification, AllocateOnlyFieldHasSameLayout) {
+    type_erased_field< Real > copy(outField);
+    type_erased_field< Real > allocated(outField, allocate_only);
+
+    ASSERT_NE(allocated.data(), outView.data());
+    ASSERT_EQ(allocated.i_size(), copy.i_size());
+    ASSERT_EQ(allocated.j_size(), copy.j_size());
+    ASSERT_EQ(allocated.k_size(), copy.k_size());
+    ASSERT_EQ(allocated.i_stride(), copy.i_stride());
+    ASSERT_EQ(allocated.j_stride(), copy.j_stride());
+    ASSERT_EQ(allocated.k_stride(), copy.k_stride());
+    ASSERT_EQ(allocated.name(), "output");
+}
+
+TEST_F(test_Verification, CopyFieldCopiesAllValues) {
+    type_erased_field< Real > allocated(outField, allocate_only);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    for (int k = 0; k < kSize; ++k)
+        for (int j = 0; j < jSize; ++j)
+            for (int i = 0; i < iSize; ++i)
+                outView(i, j, k) = i + 100 * j + 10000 * k;
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    // Same layout (block copy) and type erased views (element-wise copy)
+    copy_field(outView, allocated.to_view());
+    copy_field(allocated.to_view(), refView);
+
+    for (int k = 0; k < kSize; ++k)
+        for (int j = 0; j < jSize; ++j)
+            for (int i = 0; i < iSize; ++i) {
+                ASSERT_DOUBLE_EQ(allocated(i, j, k), outView(i, j, k));
+                ASSERT_DOUBLE_EQ(refView(i, j, k), outView(i, j, k));
+            }
+}
+
 TEST_F(test_Verification, ModifiedFieldShouldFail) {
     error_metric< Real > errorMetric(1e-6, 1e-8);
 
@@ -66,4 +107,278 @@ TEST_F(test_Verification, ModifiedFieldShouldFail) {
     ASSERT_FALSE(test.verify(errorMetric).passed());
 }
 
+TEST_F(test_Verification, FailuresAreRecordedAtTheirPosition) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    outView(5, 6, 7) = 2;
+    outView(iSize - 1, jSize - 1, kSize - 1) = 3;
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    ASSERT_TRUE(outView.is_strided());
+
+    verification< Real > test(outView, refView);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+    ASSERT_EQ(test.failures().size(), 2);
+
+    const auto &first = test.failures()[0];
+    ASSERT_EQ(first.i, 5);
+    ASSERT_EQ(first.j, 6);
+    ASSERT_EQ(first.k, 7);
+    ASSERT_DOUBLE_EQ(first.outVal, 2);
+    ASSERT_DOUBLE_EQ(first.refVal, -1);
+
+    // The failure on the boundary is excluded by the boundary extent
+    verification< Real > testInner(outView, refView, boundary_extent(0, -1, 0, -1, 0, -1));
+    ASSERT_FALSE(testInner.verify(errorMetric).passed());
+    ASSERT_EQ(testInner.failures().size(), 1);
+}
+
+TEST_F(test_Verification, ParallelVerificationMatchesSerial) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    for (int k = 0; k < kSize; k += 3)
+        outView(k % iSize, (2 * k) % jSize, k) = 2;
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    verification< Real > serial(outView, refView);
+    ASSERT_FALSE(serial.verify(errorMetric).passed());
+
+    verification< Real > parallel(outView, refView);
+    parallel.set_num_threads(7);
+    ASSERT_FALSE(parallel.verify(errorMetric).passed());
+
+    // Failures are merged in (k, j, i) order
+    ASSERT_EQ(parallel.failures().size(), serial.failures().size());
+    for (std::size_t n = 0; n < serial.failures().size(); ++n) {
+        ASSERT_EQ(parallel.failures()[n].i, serial.failures()[n].i);
+        ASSERT_EQ(parallel.failures()[n].j, serial.failures()[n].j);
+        ASSERT_EQ(parallel.failures()[n].k, serial.failures()[n].k);
+    }
+}
+
+TEST_F(test_Verification, SlabVerificationMatchesWholeField) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    for (int k = 0; k < kSize; k += 2)
+        outView(k % iSize, (3 * k) % jSize, k) = 2;
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    verification< Real > whole(outView, refView);
+    ASSERT_FALSE(whole.verify(errorMetric).passed());
+
+    // The slabs cover all layers in order
+    std::vector< std::pair< int, int > > slabs;
+    verification< Real > slabbed(outView, refView);
+    slabbed.set_num_threads(3);
+    slabbed.set_max_failures(2);
+    slabbed.set_slabs(3, [&](int kBegin, int kEnd) { slabs.emplace_back(kBegin, kEnd); });
+    ASSERT_FALSE(slabbed.verify(errorMetric).passed());
+
+    ASSERT_EQ(slabs.size(), std::size_t((kSize + 2) / 3));
+    for (std::size_t n = 0; n < slabs.size(); ++n) {
+        ASSERT_EQ(slabs[n].first, int(3 * n));
+        ASSERT_EQ(slabs[n].second, std::min(int(3 * n + 3), kSize));
+    }
+
+    // The stored failures are the first ones of the whole field
+    ASSERT_EQ(slabbed.num_failures(), whole.num_failures());
+    ASSERT_EQ(slabbed.failures().size(), std::min< std::size_t >(2, whole.failures().size()));
+    for (std::size_t n = 0; n < slabbed.failures().size(); ++n) {
+        ASSERT_EQ(slabbed.failures()[n].i, whole.failures()[n].i);
+        ASSERT_EQ(slabbed.failures()[n].j, whole.failures()[n].j);
+        ASSERT_EQ(slabbed.failures()[n].k, whole.failures()[n].k);
+    }
+}
+
+namespace {
+    // Metric policy which only provides a non-virtual equal()
+    struct sign_metric {
+        bool equal(Real a, Real b) const noexcept { return (a < 0) == (b < 0); }
+    };
+} // namespace
+
+TEST_F(test_Verification, StaticErrorMetricPolicies) {
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    outView(5, 5, 5) = -1 + 1e-12;
+    outView(6, 6, 6) = 2;
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    verification< Real > test(outView, refView);
+
+    ASSERT_FALSE(test.verify(exact_error_metric< Real >()).passed());
+    ASSERT_EQ(test.failures().size(), 2);
+
+    ASSERT_FALSE(test.verify(error_metric< Real >(1e-6, 1e-8)).passed());
+    ASSERT_EQ(test.failures().size(), 1);
+
+    ASSERT_FALSE(test.verify(sign_metric()).passed());
+    ASSERT_EQ(test.failures().size(), 1);
+
+    // The virtual interface yields the same result as the static policy
+    const error_metric_interface< Real > &errorMetric = absolute_error_metric< Real >(1e-8);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+    ASSERT_EQ(test.failures().size(), 1);
+}
+
+TEST_F(test_Verification, CappedAndCountingVerification) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    for (int k = 0; k < kSize; ++k)
+        outView(1, 2, k) = 2;
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    verification< Real > test(outView, refView);
+    test.set_num_threads(3);
+
+    // Store the first 5 failures only
+    test.set_max_failures(5);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+    ASSERT_EQ(test.num_failures(), kSize);
+    ASSERT_EQ(test.failures().size(), 5);
+    for (int k = 0; k < 5; ++k)
+        ASSERT_EQ(test.failures()[k].k, k);
+
+    // Only count the failures
+    test.set_max_failures(0);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+    ASSERT_TRUE(test.has_errors());
+    ASSERT_EQ(test.num_failures(), kSize);
+    ASSERT_TRUE(test.failures().empty());
+}
+
+TEST_F(test_Verification, ErrorStatistics) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    outView(1, 2, 3) = 1;  // absolute error 2, relative error 2
+    outView(4, 5, 6) = -4; // absolute error 3, relative error 3
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    verification< Real > test(outView, refView);
+    test.set_num_threads(4);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+
+    const error_statistics &stats = test.statistics();
+    ASSERT_EQ(stats.num_points(), iSize * jSize * kSize);
+    ASSERT_DOUBLE_EQ(stats.max_absolute_error(), 3);
+    ASSERT_DOUBLE_EQ(stats.linf_norm(), 3);
+    ASSERT_DOUBLE_EQ(stats.max_relative_error(), 3);
+    ASSERT_DOUBLE_EQ(stats.l2_norm(), std::sqrt(13.0));
+    ASSERT_DOUBLE_EQ(stats.rms_error(), std::sqrt(13.0 / (iSize * jSize * kSize)));
+    ASSERT_TRUE(stats.has_worst_point());
+    ASSERT_EQ(stats.worst_i(), 4);
+    ASSERT_EQ(stats.worst_j(), 5);
+    ASSERT_EQ(stats.worst_k(), 6);
+}
+
+TEST_F(test_Verification, WorstFailuresAreTrackedWithoutStoringFailures) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    outView(1, 2, 3) = 1;  // absolute error 2
+    outView(4, 5, 6) = -4; // absolute error 3
+    outView(7, 8, 9) = 0;  // absolute error 1
+    outView(2, 2, 2) = 1;  // absolute error 2, precedes (1, 2, 3) in (k, j, i) order
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    verification< Real > test(outView, refView);
+    test.set_num_threads(4);
+    test.set_max_failures(0);
+    test.set_worst_failures(2);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+    ASSERT_TRUE(test.failures().empty());
+
+    const auto &worst = test.worst_absolute_failures();
+    ASSERT_EQ(worst.size(), 2);
+    ASSERT_EQ(worst[0].k, 6);
+    ASSERT_EQ(worst[1].k, 2);
+
+    // The reference is -1 everywhere, hence the relative errors rank like the absolute ones
+    ASSERT_EQ(test.worst_relative_failures().size(), 2);
+    ASSERT_EQ(test.worst_relative_failures()[0].k, 6);
+}
+
+TEST_F(test_Verification, ErrorHistogramsAndMismatchesPerK) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+#endif
+    outView(1, 2, 3) = 1;         // absolute error 2, relative error 2
+    outView(4, 5, 6) = -1.005;    // absolute error 5e-3, relative error 5e-3
+    outView(7, 8, 6) = -1 - 1e-7; // within the tolerance
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+#endif
+
+    verification< Real > test(outView, refView);
+    test.set_num_threads(4);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+
+    const error_statistics &stats = test.statistics();
+    const error_histogram &absHistogram = stats.absolute_error_histogram();
+    ASSERT_EQ(absHistogram.total(), 3);
+    ASSERT_EQ(absHistogram.count(0 - error_histogram::min_exponent), 1);
+    ASSERT_EQ(absHistogram.count(-3 - error_histogram::min_exponent), 1);
+    ASSERT_EQ(absHistogram.count(-7 - error_histogram::min_exponent), 1);
+    ASSERT_EQ(stats.relative_error_histogram().count(-3 - error_histogram::min_exponent), 1);
+
+    // Only the mismatches of the error metric are counted per layer
+    ASSERT_EQ(stats.num_mismatches(3), 1);
+    ASSERT_EQ(stats.num_mismatches(6), 1);
+    ASSERT_EQ(stats.num_mismatches(5), 0);
+    ASSERT_EQ(stats.mismatches_per_k().size(), 7);
+}
+
+TEST_F(test_Verification, IdenticalNaNsDoNotMatch) {
+    error_metric< Real > errorMetric(1e-6, 1e-8);
+
+#ifdef DYCORE_USE_GPU
+    outField.d2h_update();
+    refField.d2h_update();
+#endif
+    outView(3, 4, 5) = std::nan("");
+    refView(3, 4, 5) = std::nan("");
+#ifdef DYCORE_USE_GPU
+    outField.h2d_update();
+    refField.h2d_update();
+#endif
+
+    verification< Real > test(outView, refView);
+    ASSERT_FALSE(test.verify(errorMetric).passed());
+    ASSERT_EQ(test.num_failures(), 1);
+}
+
 #endif
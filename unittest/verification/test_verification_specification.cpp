@@ -0,0 +1,104 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gmock/gmock.h>
+#include <gridtools_verification/core/command_line.h>
+#include <gridtools_verification/verification/verification_specification.h>
+
+using namespace gt_verification;
+
+namespace {
+    verification_specification make_specification(const char *errorStr) {
+        const char *argv[] = {"test_verification", errorStr};
+        command_line cl(errorStr ? 2 : 1, argv);
+        return verification_specification(cl);
+    }
+} // namespace
+
+TEST(test_VerificationSpecification, max_failures_to_store) {
+    // Nothing is reported, failures are only counted
+    auto countOnly = make_specification(nullptr);
+    ASSERT_EQ(countOnly.max_failures_to_store("u"), 0);
+
+    // Only the listed failures are stored
+    auto capped = make_specification("--error=max-errors=10");
+    ASSERT_TRUE(capped.list());
+    ASSERT_EQ(capped.max_failures_to_store("u"), 10);
+
+    // Failures of other fields are not reported
+    auto field = make_specification("--error=list,field=u");
+    ASSERT_GT(field.max_failures_to_store("u"), 0);
+    ASSERT_EQ(field.max_failures_to_store("v"), 0);
+
+    // Visualizing needs all the failures
+    auto visualize = make_specification("--error=visualize,max-errors=10");
+    ASSERT_LT(visualize.max_failures_to_store("u"), 0);
+
+    // So does finding the failing regions
+    auto regions = make_specification("--error=regions");
+    ASSERT_TRUE(regions.regions());
+    ASSERT_LT(regions.max_failures_to_store("u"), 0);
+}
+
+TEST(test_VerificationSpecification, prefetch) {
+    ASSERT_FALSE(make_specification(nullptr).prefetch());
+    ASSERT_TRUE(make_specification("--prefetch").prefetch());
+}
+
+TEST(test_VerificationSpecification, stream_slab) {
+    ASSERT_EQ(make_specification(nullptr).stream_slab(), 0);
+    ASSERT_EQ(make_specification("--stream=8").stream_slab(), 8);
+}
+
+TEST(test_VerificationSpecification, stream_slab_disables_prefetch) {
+    const char *argv[] = {"test_verification", "--prefetch", "--stream=8"};
+    command_line cl(3, argv);
+    verification_specification spec(cl);
+    ASSERT_EQ(spec.stream_slab(), 8);
+    ASSERT_FALSE(spec.prefetch());
+}
+
+TEST(test_VerificationSpecification, k_ranges) {
+    ASSERT_FALSE(make_specification(nullptr).k_interval_specified());
+
+    // Ranges are sorted and overlapping or adjacent ones are merged
+    auto spec = make_specification("--error=k=20-30,k=6,k=1-5,k=25-40");
+    ASSERT_TRUE(spec.k_interval_specified());
+    ASSERT_EQ(spec.k_ranges().size(), 2);
+    ASSERT_EQ(spec.k_ranges()[0], std::make_pair(1, 6));
+    ASSERT_EQ(spec.k_ranges()[1], std::make_pair(20, 40));
+
+    ASSERT_FALSE(spec.in_k_interval(0));
+    ASSERT_TRUE(spec.in_k_interval(1));
+    ASSERT_TRUE(spec.in_k_interval(6));
+    ASSERT_FALSE(spec.in_k_interval(7));
+    ASSERT_TRUE(spec.in_k_interval(40));
+    ASSERT_FALSE(spec.in_k_interval(41));
+}
+
+TEST(test_VerificationSpecification, report) {
+    ASSERT_TRUE(make_specification(nullptr).report_path().empty());
+
+    // All failures are stored for the report unless max-errors is given
+    auto report = make_specification("--error=report=failures.csv,format=csv");
+    ASSERT_EQ(report.report_path(), "failures.csv");
+    ASSERT_EQ(report.report_file_format(), report_format::csv);
+    ASSERT_LT(report.max_failures_to_store("u"), 0);
+    ASSERT_EQ(make_specification("--error=report=failures.jsonl,max-errors=10").max_failures_to_store("u"), 10);
+}
+
+TEST(test_VerificationSpecification, worst_failures) {
+    ASSERT_EQ(make_specification(nullptr).worst_failures(), 0);
+
+    // The worst failures are tracked separately, nothing needs to be stored
+    auto worst = make_specification("--error=worst=5");
+    ASSERT_EQ(worst.worst_failures(), 5);
+    ASSERT_EQ(worst.max_failures_to_store("u"), 0);
+}